@@ -18,10 +18,54 @@ include $(CLEAR_VARS)
 
 LOCAL_MODULE    := gunner
 LOCAL_CFLAGS    := -Werror
-LOCAL_SRC_FILES :=  main.cpp
+# The particle step relies on loop vectorization, which -O2 leaves off
+LOCAL_CFLAGS    += -ftree-vectorize
+LOCAL_SRC_FILES :=  main.cpp game.cpp glUtil.cpp hud.cpp meteorBatch.cpp particleBatch.cpp outlineBatch.cpp \
+                    renderTarget.cpp gpuTimer.cpp \
+                    waveScheduler.cpp waves.cpp world.cpp node.cpp shuttle.cpp meteor.cpp smallMeteor.cpp bullet.cpp \
+                    eventQueue.cpp memoryBudget.cpp nodePool.cpp inputQueue.cpp latencyHistogram.cpp \
+                    shapeFactory.cpp particles.cpp spatialGrid.cpp autopilot.cpp \
+                    trace.cpp allocTracker.cpp framePacer.cpp resolutionScaler.cpp outline.cpp kernels.cpp util.cpp
 LOCAL_LDLIBS    := -llog -landroid -lEGL -lGLESv2
 LOCAL_STATIC_LIBRARIES := cpufeatures android_native_app_glue ndk_helper
 
+# SIMD kernel variants, picked at runtime by initKernels
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+LOCAL_CFLAGS += -DHAVE_NEON_KERNELS=1
+LOCAL_SRC_FILES += kernelsNeon.cpp.neon
+endif
+ifeq ($(TARGET_ARCH_ABI),arm64-v8a)
+LOCAL_CFLAGS += -DHAVE_NEON_KERNELS=1
+LOCAL_SRC_FILES += kernelsNeon.cpp
+endif
+ifneq ($(filter x86 x86_64,$(TARGET_ARCH_ABI)),)
+LOCAL_CFLAGS += -DHAVE_X86_KERNELS=1
+LOCAL_SRC_FILES += kernelsX86.cpp
+endif
+
+# ndk-build GUNNER_LTO=1 links with link time optimization
+ifeq ($(GUNNER_LTO),1)
+LOCAL_CFLAGS += -flto
+LOCAL_LDFLAGS += -flto
+endif
+
+# ndk-build GUNNER_ALLOC_TRACKING=1 counts allocations per frame and call
+# site through a global operator new, which the release app goes without
+ifeq ($(GUNNER_ALLOC_TRACKING),1)
+LOCAL_CFLAGS += -DGUNNER_ALLOC_TRACKING=1
+endif
+
+# ndk-build GUNNER_PGO=generate records a profile while playing,
+# pull it from GUNNER_PGO_DIR and build again with GUNNER_PGO=use
+GUNNER_PGO_DIR ?= /sdcard/gunner-pgo
+ifeq ($(GUNNER_PGO),generate)
+LOCAL_CFLAGS += -fprofile-generate=$(GUNNER_PGO_DIR)
+LOCAL_LDFLAGS += -fprofile-generate=$(GUNNER_PGO_DIR)
+endif
+ifeq ($(GUNNER_PGO),use)
+LOCAL_CFLAGS += -fprofile-use=$(GUNNER_PGO_DIR) -fprofile-correction
+endif
+
 ifneq ($(filter %armeabi-v7a,$(TARGET_ARCH_ABI)),)
 LOCAL_CFLAGS += -mhard-float -D_NDK_MATH_NO_SOFTFP=1
 LOCAL_LDLIBS += -lm_hard
@@ -0,0 +1,123 @@
+#include "allocTracker.h"
+
+#if GUNNER_ALLOC_TRACKING
+
+#include <new>
+#include <stdlib.h>
+
+#include "util.h"
+
+// Plain data, so allocations made before static constructors run still count
+static AllocCounters totals = { 0, 0, 0 };
+static AllocCounters untagged = { 0, 0, 0 };
+static AllocSite* sites = NULL;
+
+static __thread AllocSite* currentSite = NULL;
+static __thread uint64_t threadAllocations = 0;
+
+AllocSite::AllocSite(const char* name)
+    : name(name), allocations(0), bytes(0)
+{
+    // Sites are static, so they are only ever pushed
+    next = __atomic_load_n(&sites, __ATOMIC_ACQUIRE);
+    while (!__atomic_compare_exchange_n(&sites, &next, this, false,
+        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {}
+}
+
+AllocTagScope::AllocTagScope(AllocSite* site) : previous_(currentSite) {
+    currentSite = site;
+}
+
+AllocTagScope::~AllocTagScope() {
+    currentSite = previous_;
+}
+
+AllocCounters allocTotals() {
+    AllocCounters counters;
+    counters.allocations = __atomic_load_n(&totals.allocations, __ATOMIC_RELAXED);
+    counters.frees = __atomic_load_n(&totals.frees, __ATOMIC_RELAXED);
+    counters.bytes = __atomic_load_n(&totals.bytes, __ATOMIC_RELAXED);
+    return counters;
+}
+
+uint64_t allocThreadCount() {
+    return threadAllocations;
+}
+
+uint64_t AllocFrameCounter::end() {
+    uint64_t allocations = allocThreadCount() - start_;
+    frames_++;
+    if (allocations > 0) { dirtyFrames_++; }
+    if (allocations > maxAllocations_) { maxAllocations_ = allocations; }
+    return allocations;
+}
+
+void AllocFrameCounter::log(const char* name) {
+    LOGI("%s: %u of %u frames allocated, at most %llu allocations in a frame",
+        name, dirtyFrames_, frames_, (unsigned long long) maxAllocations_);
+}
+
+void allocLogSites() {
+    LOGI("Allocations untagged: %llu, %llu bytes",
+        (unsigned long long) __atomic_load_n(&untagged.allocations, __ATOMIC_RELAXED),
+        (unsigned long long) __atomic_load_n(&untagged.bytes, __ATOMIC_RELAXED));
+    for (AllocSite* site = __atomic_load_n(&sites, __ATOMIC_ACQUIRE); site != NULL; site = site->next) {
+        uint64_t allocations = __atomic_load_n(&site->allocations, __ATOMIC_RELAXED);
+        if (allocations == 0) { continue; }
+        LOGI("Allocations at %s: %llu, %llu bytes", site->name, (unsigned long long) allocations,
+            (unsigned long long) __atomic_load_n(&site->bytes, __ATOMIC_RELAXED));
+    }
+}
+
+static void* track(size_t size) {
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == NULL) {
+        // Built without exceptions, so there is no bad_alloc to throw
+        LOGE("Out of memory allocating %u bytes", (unsigned) size);
+        abort();
+    }
+
+    AllocSite* site = currentSite;
+    if (site != NULL) {
+        __atomic_add_fetch(&site->allocations, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&site->bytes, size, __ATOMIC_RELAXED);
+    } else {
+        __atomic_add_fetch(&untagged.allocations, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&untagged.bytes, size, __ATOMIC_RELAXED);
+    }
+    __atomic_add_fetch(&totals.allocations, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&totals.bytes, size, __ATOMIC_RELAXED);
+    threadAllocations++;
+    return p;
+}
+
+static void untrack(void* p) {
+    if (p == NULL) { return; }
+
+    __atomic_add_fetch(&totals.frees, 1, __ATOMIC_RELAXED);
+    free(p);
+}
+
+// Dynamic exception specifications are gone from C++17 on
+#if __cplusplus >= 201103L
+#define ALLOC_THROWS noexcept(false)
+#define ALLOC_NOTHROW noexcept
+#else
+#define ALLOC_THROWS throw(std::bad_alloc)
+#define ALLOC_NOTHROW throw()
+#endif
+
+void* operator new(size_t size) ALLOC_THROWS { return track(size); }
+void* operator new[](size_t size) ALLOC_THROWS { return track(size); }
+void* operator new(size_t size, const std::nothrow_t&) ALLOC_NOTHROW { return track(size); }
+void* operator new[](size_t size, const std::nothrow_t&) ALLOC_NOTHROW { return track(size); }
+void operator delete(void* p) ALLOC_NOTHROW { untrack(p); }
+void operator delete[](void* p) ALLOC_NOTHROW { untrack(p); }
+void operator delete(void* p, const std::nothrow_t&) ALLOC_NOTHROW { untrack(p); }
+void operator delete[](void* p, const std::nothrow_t&) ALLOC_NOTHROW { untrack(p); }
+#ifdef __cpp_sized_deallocation
+void operator delete(void* p, size_t) ALLOC_NOTHROW { untrack(p); }
+void operator delete[](void* p, size_t) ALLOC_NOTHROW { untrack(p); }
+#endif
+
+#endif
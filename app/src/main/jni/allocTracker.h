@@ -0,0 +1,91 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Counters of the global operator new and delete
+struct AllocCounters {
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t bytes;
+};
+
+// Allocation tracking replaces the global operator new and delete, so it
+// is only built in with GUNNER_ALLOC_TRACKING=1, which the host build sets.
+// Without it the counters read zero and ALLOC_TAG compiles to nothing.
+#if GUNNER_ALLOC_TRACKING
+
+// Call site of allocations, set for a scope with ALLOC_TAG
+struct AllocSite {
+    const char* name;
+    uint64_t allocations;
+    uint64_t bytes;
+    AllocSite* next;
+
+    AllocSite(const char* name);
+};
+
+// All threads together
+AllocCounters allocTotals();
+
+// Allocations made by the calling thread only, which is what a frame
+// check wants when other threads run besides it
+uint64_t allocThreadCount();
+// Logs every site that allocated
+void allocLogSites();
+
+// Allocations per frame, for telling a clean steady state from a leaky one.
+// Only the thread calling begin and end is counted, so workers running
+// besides the frame aren't charged to it.
+class AllocFrameCounter {
+    uint64_t start_;
+    unsigned frames_;
+    unsigned dirtyFrames_;
+    uint64_t maxAllocations_;
+
+public:
+    AllocFrameCounter() : start_(allocThreadCount()), frames_(0), dirtyFrames_(0), maxAllocations_(0) {};
+    void begin() { start_ = allocThreadCount(); }
+    // Returns the allocations made since begin
+    uint64_t end();
+    void reset() { frames_ = dirtyFrames_ = 0; maxAllocations_ = 0; }
+    void log(const char* name);
+};
+
+class AllocTagScope {
+    AllocSite* previous_;
+
+public:
+    AllocTagScope(AllocSite* site);
+    ~AllocTagScope();
+};
+
+#define ALLOC_CONCAT2(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT2(a, b)
+// Charges the allocations of the rest of the scope to a named site
+#define ALLOC_TAG(name) \
+    static AllocSite ALLOC_CONCAT(allocSite, __LINE__)(name); \
+    AllocTagScope ALLOC_CONCAT(allocTag, __LINE__)(&ALLOC_CONCAT(allocSite, __LINE__))
+
+#else
+
+// Built without tracking: operator new is the system's and every count
+// stays zero
+inline AllocCounters allocTotals() { AllocCounters counters = { 0, 0, 0 }; return counters; }
+inline uint64_t allocThreadCount() { return 0; }
+inline void allocLogSites() {}
+
+class AllocFrameCounter {
+public:
+    void begin() {}
+    uint64_t end() { return 0; }
+    void reset() {}
+    void log(const char*) {}
+};
+
+#define ALLOC_TAG(name)
+
+#endif
+
+#endif
@@ -0,0 +1,97 @@
+#include "autopilot.h"
+
+#include <math.h>
+
+#include "trace.h"
+
+const float Autopilot::tapInterval = 0.1f;
+const float Autopilot::dangerHorizon = 1.0f;
+const float Autopilot::margin = 0.05f;
+
+void Autopilot::reset() {
+    lastTap_ = -1.0;
+    taps_ = 0;
+    dodges_ = 0;
+}
+
+// Where the meteor will be when it comes down to the shuttle top
+float Autopilot::impactX(Meteor* meteor, double now, float top, float& halfWidth) {
+    float xmin, xmax, ymin, ymax;
+    meteor->getBounds(xmin, xmax, ymin, ymax);
+    halfWidth = (xmax - xmin) / 2;
+
+    double t = fmax(meteor->getThreatTime(top), now);
+    return meteor->getSpawnX() + meteor->getXFallSpeed() * (float) (t - meteor->getSpawnTime());
+}
+
+// Distance from x to the closest meteor landing soon, minus its width
+float Autopilot::clearance(float x, Node** threats, int count, double now, float top) {
+    float closest = 2.0f * (XMAX - XMIN);
+    for (int i = 0; i < count; ++i) {
+        Meteor* meteor = (Meteor*) threats[i];
+        if (meteor->getThreatTime(top) - now > dangerHorizon) { continue; }
+
+        float halfWidth;
+        float gap = fabs(impactX(meteor, now, top, halfWidth) - x) - halfWidth;
+        closest = fmin(closest, gap);
+    }
+    return closest;
+}
+
+void Autopilot::act(World& world, int64_t time) {
+    TRACE_SCOPE("Autopilot::act");
+    double now = world.getTime();
+    if (now < lastTap_) { lastTap_ = -1.0; }
+    if (world.isOver() || now - lastTap_ < tapInterval) { return; }
+
+    Shuttle* shuttle = world.getShuttle();
+    float x = shuttle->getX();
+    float top = shuttle->getTop();
+    float xmin, xmax, ymin, ymax;
+    shuttle->getBounds(xmin, xmax, ymin, ymax);
+    float safe = (xmax - xmin) / 2 + margin;
+
+    Node* threats[AUTOPILOT_NEAREST];
+    int count = world.findNearest(x, top, AUTOPILOT_NEAREST, threats);
+    if (count == 0) { return; }
+
+    float target = x;
+    if (clearance(x, threats, count, now, top) < safe) {
+        // Step to whichever side leaves the most room, staying on the playfield
+        float step = Shuttle::getSpeed();
+        float best = -1.0f;
+        float candidates[4] = { x - step, x + step, x - 2 * step, x + 2 * step };
+        for (int i = 0; i < 4; ++i) {
+            if (fabs(candidates[i]) > world.getSky()) { continue; }
+            float room = clearance(candidates[i], threats, count, now, top);
+            if (room > best) {
+                best = room;
+                target = candidates[i];
+            }
+        }
+        dodges_++;
+    } else {
+        // Aim at the meteor that lands first, where the bullet will meet it
+        Meteor* urgent = NULL;
+        double soonest = 0.0;
+        for (int i = 0; i < count; ++i) {
+            Meteor* meteor = (Meteor*) threats[i];
+            if (meteor->getY() < Bullet::getStartY()) { continue; }
+            double t = meteor->getThreatTime(top);
+            if (urgent == NULL || t < soonest) {
+                urgent = meteor;
+                soonest = t;
+            }
+        }
+        if (urgent == NULL) { return; }
+
+        float flight = (urgent->getY() - Bullet::getStartY()) /
+            (Bullet::getSpeed() - urgent->getYFallSpeed());
+        target = urgent->getX() + urgent->getXFallSpeed() * flight;
+        if (fabs(target) > world.getSky()) { return; }
+    }
+
+    world.getInput().push(target, top, time);
+    lastTap_ = now;
+    taps_++;
+}
@@ -0,0 +1,37 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include <stdint.h>
+
+#include "world.h"
+
+// Meteors the autopilot looks at every frame
+#define AUTOPILOT_NEAREST 6
+
+// Plays the game by itself for hands free sessions. Every frame it looks
+// at the meteors nearest to the shuttle, dodges the ones about to land on
+// it and otherwise shoots the most urgent one. Taps go through the input
+// queue like real ones, so the whole input path is exercised.
+class Autopilot {
+    // Simulation time of the last tap
+    double lastTap_;
+    unsigned taps_;
+    unsigned dodges_;
+
+    static const float tapInterval;
+    static const float dangerHorizon;
+    static const float margin;
+
+    float impactX(Meteor* meteor, double now, float top, float& halfWidth);
+    float clearance(float x, Node** threats, int count, double now, float top);
+
+public:
+    Autopilot() { reset(); };
+    // Forget the last game, call when a new world starts
+    void reset();
+    void act(World& world, int64_t time);
+    unsigned getTaps() { return taps_; }
+    unsigned getDodges() { return dodges_; }
+};
+
+#endif
@@ -0,0 +1,166 @@
+#include "batchRunner.h"
+
+#include <algorithm>
+#include <time.h>
+#include <unistd.h>
+
+#include "util.h"
+#include "world.h"
+#include "autopilot.h"
+#include "random.h"
+#include "trace.h"
+
+using namespace std;
+
+static int64_t threadCpuNanos() {
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (int64_t) now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+// Value below which the given fraction of the sorted values falls
+static double percentile(const vector<double>& sorted, float fraction) {
+    size_t i = (size_t) (fraction * (sorted.size() - 1) + 0.5f);
+    return sorted[i];
+}
+
+BatchRunner::BatchRunner(const BatchSettings& settings)
+    : settings_(settings), next_(0), threads_(settings.threads), elapsed_(0), cpuNanos_(0)
+{
+    if (settings_.spawnRates.empty()) { settings_.spawnRates.push_back(1.0f); }
+    if (threads_ <= 0) { threads_ = (int) sysconf(_SC_NPROCESSORS_ONLN); }
+    if (threads_ < 1) { threads_ = 1; }
+    if (threads_ > BATCH_MAX_THREADS) { threads_ = BATCH_MAX_THREADS; }
+    results_.resize(settings_.games);
+}
+
+// Plays game index from start to game over or the frame limit
+void BatchRunner::play(int index) {
+    GameResult& result = results_[index];
+    result.seed = settings_.seed + index;
+    result.spawnRate = settings_.spawnRates[index % settings_.spawnRates.size()];
+
+    World world(0.6f, result.seed);
+    world.setWaves(settings_.waves);
+    world.setSpawnRate(result.spawnRate);
+    if (settings_.debris >= 0) { world.setDebris(settings_.debris); }
+    Autopilot pilot;
+    // Scripted taps have their own generator, like the world's own it is per game
+    Random script(result.seed * 2654435761u + 1);
+
+    double dt = settings_.dt;
+    int64_t frameNanos = (int64_t) (dt * 1e9);
+    int frame = 0;
+    while (!world.isOver() && frame < settings_.maxFrames) {
+        frame++;
+        int64_t frameTime = frame * frameNanos;
+        if (settings_.autopilot) {
+            pilot.act(world, frameTime);
+        } else if (script.uniform() < 4.0 * dt) {
+            // A few taps a second, stamped somewhere within the last frame
+            float x = script.uniform() * 1.2f - 0.6f;
+            world.getInput().push(x, 0.0f, frameTime - (int64_t) (script.uniform() * frameNanos));
+        }
+        world.step(dt, frameTime);
+    }
+
+    result.score = world.getScore();
+    result.survival = world.getTime();
+    result.frames = frame;
+    result.finished = world.isOver();
+}
+
+void* BatchRunner::run(void* arg) {
+    BatchRunner* runner = (BatchRunner*) arg;
+    traceThreadName("batch");
+    int64_t cpuStart = threadCpuNanos();
+
+    for (;;) {
+        int index = __atomic_fetch_add(&runner->next_, 1, __ATOMIC_RELAXED);
+        if (index >= runner->settings_.games) { break; }
+        TRACE_SCOPE("BatchRunner::play");
+        runner->play(index);
+    }
+
+    __atomic_add_fetch(&runner->cpuNanos_, threadCpuNanos() - cpuStart, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+bool BatchRunner::run() {
+    next_ = 0;
+    cpuNanos_ = 0;
+    int64_t start = monotonicNanos();
+
+    pthread_t threads[BATCH_MAX_THREADS];
+    int started = 0;
+    for (int i = 0; i < threads_; ++i) {
+        if (pthread_create(&threads[started], NULL, run, this) != 0) {
+            LOGE("Could not start batch thread %d", i);
+            continue;
+        }
+        started++;
+    }
+    if (started == 0) { return false; }
+    threads_ = started;
+
+    for (int i = 0; i < started; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    elapsed_ = monotonicNanos() - start;
+    return true;
+}
+
+void BatchRunner::logResults(float spawnRate) {
+    vector<double> scores;
+    vector<double> survivals;
+    int unfinished = 0;
+    for (size_t i = 0; i < results_.size(); ++i) {
+        if (results_[i].spawnRate != spawnRate) { continue; }
+        scores.push_back(results_[i].score);
+        survivals.push_back(results_[i].survival);
+        if (!results_[i].finished) { unfinished++; }
+    }
+    if (scores.empty()) { return; }
+
+    double scoreSum = 0.0;
+    double survivalSum = 0.0;
+    for (size_t i = 0; i < scores.size(); ++i) {
+        scoreSum += scores[i];
+        survivalSum += survivals[i];
+    }
+    sort(scores.begin(), scores.end());
+    sort(survivals.begin(), survivals.end());
+
+    LOGI("Spawn rate %.2f: %u games, %d still alive at the frame limit",
+        spawnRate, (unsigned) scores.size(), unfinished);
+    LOGI("  Score: mean %.1f, min %.0f, median %.0f, 90th %.0f, max %.0f",
+        scoreSum / scores.size(), scores.front(), percentile(scores, 0.5f),
+        percentile(scores, 0.9f), scores.back());
+    LOGI("  Survival: mean %.1f s, min %.1f s, median %.1f s, 90th %.1f s, max %.1f s",
+        survivalSum / survivals.size(), survivals.front(), percentile(survivals, 0.5f),
+        percentile(survivals, 0.9f), survivals.back());
+}
+
+void BatchRunner::log() {
+    long long frames = 0;
+    for (size_t i = 0; i < results_.size(); ++i) { frames += results_[i].frames; }
+
+    double seconds = elapsed_ / 1e9;
+    // More threads than cores don't make more cores busy
+    int cores = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 1 || cores > threads_) { cores = threads_; }
+    double cpuSeconds = cpuNanos_ / 1e9;
+    LOGI("Batch: %d games, %lld frames in %.3f s on %d threads", settings_.games, frames,
+        seconds, threads_);
+    LOGI("Throughput: %.0f sim frames/s, %.0f sim frames/s per core, %.0f per CPU second",
+        frames / seconds, frames / seconds / cores, cpuSeconds > 0.0 ? frames / cpuSeconds : 0.0);
+
+    // Rates in the order they were given, each once
+    for (size_t i = 0; i < settings_.spawnRates.size(); ++i) {
+        float rate = settings_.spawnRates[i];
+        if (find(settings_.spawnRates.begin(), settings_.spawnRates.begin() + i, rate) ==
+            settings_.spawnRates.begin() + i) {
+            logResults(rate);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <vector>
+
+#include "waves.h"
+
+#define BATCH_MAX_THREADS 64
+
+struct BatchSettings {
+    // Games to play, game i gets seed + i
+    int games;
+    unsigned seed;
+    // 0 uses every online core
+    int threads;
+    double dt;
+    // A game still going after this many frames is stopped and counted as survived
+    int maxFrames;
+    bool autopilot;
+    // Debris per big meteor, negative keeps the default
+    int debris;
+    // Game i spawns at spawnRates[i % size], so one batch can sweep them
+    std::vector<float> spawnRates;
+    // The curve the rates scale, and the bursts
+    WaveSettings waves;
+};
+
+struct GameResult {
+    unsigned seed;
+    float spawnRate;
+    int score;
+    // Simulation seconds until game over
+    double survival;
+    int frames;
+    bool finished;
+};
+
+// Plays many independent headless games on all cores. Every game has its
+// own world, generators and memory, so games share nothing while running
+// and a game plays the same whichever thread picks it up.
+class BatchRunner {
+    BatchSettings settings_;
+    std::vector<GameResult> results_;
+    // Index of the next game to hand out
+    int next_;
+    int threads_;
+    int64_t elapsed_;
+    // CPU time of all threads together
+    int64_t cpuNanos_;
+
+    void play(int index);
+    static void* run(void* runner);
+    void logResults(float spawnRate);
+
+public:
+    BatchRunner(const BatchSettings& settings);
+    // Returns false if no thread could be started
+    bool run();
+    void log();
+    const std::vector<GameResult>& getResults() { return results_; }
+};
+
+#endif
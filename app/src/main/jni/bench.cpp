@@ -0,0 +1,708 @@
+// Headless benchmark. Plays scripted sessions of the simulation as fast as
+// it can and reports the throughput, so the game can be profiled and
+// optimized on the host without a device or a GL context. With --batch it
+// plays many games on all cores and reports their statistics instead.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include "util.h"
+#include "kernels.h"
+#include "world.h"
+#include "autopilot.h"
+#include "trace.h"
+#include "allocTracker.h"
+#include "batchRunner.h"
+#include "framePacer.h"
+#include "outline.h"
+
+// Taps come from their own generator so the script doesn't change
+// when the world draws a different amount of random numbers
+static unsigned scriptState = 1;
+
+static float scriptRandom() {
+    scriptState = scriptState * 1103515245u + 12345u;
+    return (float) ((scriptState >> 8) & 0xffff) / 0xffff;
+}
+
+// Frames of a game before it is expected to run without allocating,
+// the first ones may still fill the shape rings and lazy statics
+#define ALLOC_WARMUP_FRAMES 600
+
+// Even-odd test on float geometry, what the kernels did before vertices were quantized
+static bool isInsideFloat(const float* vertices, int count, float x, float y) {
+    bool result = false;
+    for (int i = 0, j = count - 1; i < count; j = i++) {
+        float curX = vertices[i * 2], curY = vertices[i * 2 + 1];
+        float prevX = vertices[j * 2], prevY = vertices[j * 2 + 1];
+        if ((curY > y) != (prevY > y) &&
+            (x < (prevX - curX) * (y - curY) / (prevY - curY) + curX)) {
+            result = !result;
+        }
+    }
+    return result;
+}
+
+// Compares quantized geometry with the float geometry it came from: how far
+// vertices move on a 2160 pixel tall screen and how many points collide
+// differently. Only points within the rounding error of an edge should.
+static int verifyQuantization() {
+    const float pixels = 2160 / 2.0f;
+    float maxError = 0.0f;
+    int tests = 100000;
+    int differ = 0;
+
+    for (int test = 0; test < tests; ++test) {
+        int count = MIN_VERTEX_COUNT + (int) (scriptRandom() * (MAX_VERTEX_COUNT - MIN_VERTEX_COUNT));
+        if (count >= MAX_VERTEX_COUNT) { count = MAX_VERTEX_COUNT - 1; }
+        float scale = test % 2 == 0 ? 0.2f : 0.06f;
+
+        float unit[MAX_VERTEX_COUNT * DIMENTIONS];
+        float scaled[MAX_VERTEX_COUNT * DIMENTIONS];
+        int16_t quantized[MAX_VERTEX_COUNT * DIMENTIONS];
+        for (int i = 0; i < count * DIMENTIONS; ++i) {
+            unit[i] = scriptRandom() * 2 - 1;
+            scaled[i] = unit[i] * scale;
+            quantized[i] = quantizePosition(unit[i]);
+            float error = fabsf(dequantizePosition(quantized[i]) * scale - scaled[i]) * pixels;
+            if (error > maxError) { maxError = error; }
+        }
+
+        float x = (scriptRandom() * 2 - 1) * scale, y = (scriptRandom() * 2 - 1) * scale;
+        if (isInsideFloat(scaled, count, x, y) !=
+            scalarKernels.isInside(quantized, count, scale, scale, 0.0f, 0.0f, x, y)) {
+            differ++;
+        }
+    }
+
+    LOGI("Quantization: vertices off by at most %.4f px, %d of %d points collide differently",
+        maxError, differ, tests);
+    // Well below a pixel, and edge cases only
+    return maxError < 0.01f && differ * 1000 < tests ? 0 : 1;
+}
+
+// Distance of (x, y) from the line through a and b
+static float lineDistance(float ax, float ay, float bx, float by, float x, float y) {
+    float dx = bx - ax, dy = by - ay;
+    return fabsf(dx * (y - ay) - dy * (x - ax)) / sqrtf(dx * dx + dy * dy);
+}
+
+// Strokes meteor like polygons and checks the strip: its length, and that
+// the edges of the core stroke are half the width off the polygon's edges
+// wherever the miter isn't clipped, measured on a 2160 pixel tall screen
+static int verifyOutlines() {
+    const float pixels = 2160 / 2.0f;
+    const float halfWidth = 1.0f / pixels;
+    float maxError = 0.0f;
+    int tests = 10000;
+    int badCounts = 0;
+    int checked = 0;
+
+    for (int test = 0; test < tests; ++test) {
+        int count = MIN_VERTEX_COUNT + (int) (scriptRandom() * (MAX_VERTEX_COUNT - MIN_VERTEX_COUNT + 1));
+        if (count > MAX_VERTEX_COUNT) { count = MAX_VERTEX_COUNT; }
+        float scale = test % 2 == 0 ? 0.2f : 0.06f;
+        float fringe = test % 3 == 0 ? 0.0f : halfWidth;
+
+        int16_t vertices[MAX_VERTEX_COUNT * DIMENTIONS];
+        uint8_t colors[MAX_VERTEX_COUNT * COLOR_COMPONENTS];
+        for (int i = 0; i < count; ++i) {
+            float angle = (i + scriptRandom() * 0.8f) * 2 * M_PI / count;
+            float radius = 0.5f + scriptRandom() * 0.5f;
+            vertices[i * 2] = quantizePosition(radius * cosf(angle));
+            vertices[i * 2 + 1] = quantizePosition(radius * sinf(angle));
+        }
+        fillColor(colors, count, 1.0f, 1.0f, 1.0f, 1.0f);
+
+        OutlineVertex strip[OUTLINE_MAX_VERTICES(MAX_VERTEX_COUNT)];
+        int written = buildOutline(vertices, colors, count, scale, scale, halfWidth, fringe, strip);
+        if (written != (fringe > 0.0f ? 3 : 1) * (2 * count + 4)) { badCounts++; }
+
+        float range = scale * OUTLINE_RANGE;
+        for (int i = 0; i < count; ++i) {
+            int prev = (i + count - 1) % count, next = (i + 1) % count;
+            float px = dequantizePosition(vertices[prev * 2]) * scale;
+            float py = dequantizePosition(vertices[prev * 2 + 1]) * scale;
+            float cx = dequantizePosition(vertices[i * 2]) * scale;
+            float cy = dequantizePosition(vertices[i * 2 + 1]) * scale;
+            float nx = dequantizePosition(vertices[next * 2]) * scale;
+            float ny = dequantizePosition(vertices[next * 2 + 1]) * scale;
+
+            // Outer and inner vertex of the corner, the first ones come with a repeat
+            for (int side = 0; side < 2; ++side) {
+                const OutlineVertex& v = strip[1 + 2 * i + side + (i == 0 && side == 0 ? -1 : 0)];
+                float x = dequantizePosition(v.position[0]) * range;
+                float y = dequantizePosition(v.position[1]) * range;
+                float miter = sqrtf((x - cx) * (x - cx) + (y - cy) * (y - cy));
+                if (miter > halfWidth * OUTLINE_MITER_LIMIT * 0.99f) { continue; }
+
+                float error = fmaxf(fabsf(lineDistance(px, py, cx, cy, x, y) - halfWidth),
+                    fabsf(lineDistance(cx, cy, nx, ny, x, y) - halfWidth)) * pixels;
+                if (error > maxError) { maxError = error; }
+                checked++;
+            }
+        }
+    }
+
+    LOGI("Outlines: %d strips of the wrong length, %d corners off by at most %.4f px",
+        badCounts, checked, maxError);
+    return badCounts == 0 && maxError < 0.05f ? 0 : 1;
+}
+
+struct Spawn {
+    double time;
+    float x;
+    float xSpeed;
+    float ySpeed;
+    float rotateSpeed;
+    int vertexCount;
+    int16_t vertices[MAX_VERTEX_COUNT * DIMENTIONS];
+};
+
+// Shapes are left out when only the launch has to agree
+static bool isSameSpawn(const Spawn& a, const Spawn& b, bool shapes) {
+    return a.time == b.time && a.x == b.x && a.xSpeed == b.xSpeed && a.ySpeed == b.ySpeed &&
+        a.rotateSpeed == b.rotateSpeed && (!shapes || (a.vertexCount == b.vertexCount &&
+        memcmp(a.vertices, b.vertices, sizeof(int16_t) * a.vertexCount * DIMENTIONS) == 0));
+}
+
+// Keeps the big meteors a world launches, small ones follow the hits
+class SpawnRecorder: public WorldListener {
+public:
+    std::vector<Spawn> spawns;
+    void onMeteorAdded(Meteor* meteor) {
+        if (meteor->getType() != METEOR) { return; }
+        Spawn spawn;
+        spawn.time = meteor->getSpawnTime();
+        spawn.x = meteor->getSpawnX();
+        spawn.xSpeed = meteor->getXFallSpeed();
+        spawn.ySpeed = meteor->getYFallSpeed();
+        spawn.rotateSpeed = meteor->getRotateSpeed();
+        spawn.vertexCount = meteor->getVertexCount();
+        memcpy(spawn.vertices, meteor->getVertices(),
+            sizeof(int16_t) * spawn.vertexCount * DIMENTIONS);
+        spawns.push_back(spawn);
+    }
+    void onNodeRemoved(Node*) {}
+};
+
+struct WaveRun {
+    double fps;
+    bool autopilot;
+    // Seconds into the run to switch the bursts off at, 0 to keep them
+    double stopBursts;
+};
+
+// What a run of the waves launched
+struct WavePlay {
+    std::vector<Spawn> spawns;
+    unsigned resumes;
+    int refused;
+    // A second before the first refused spawn, or past the end
+    double cutoff;
+    // When the bursts were switched off, past the end if they weren't
+    double stopped;
+};
+
+// Plays a seed for the given seconds and records the big meteors launched
+static void playWaves(unsigned seed, const WaveSettings& waves, const WaveRun& run,
+    double seconds, WavePlay& play) {
+    World world(0.6f, seed);
+    world.setWaves(waves);
+    world.getMemoryBudget().setCap(METEOR, NODE_POOL_CAPACITY);
+    SpawnRecorder recorder;
+    world.setListener(&recorder);
+    Autopilot pilot;
+    play.cutoff = seconds + 1.0;
+    play.stopped = seconds + 1.0;
+
+    double dt = 1.0 / run.fps;
+    for (int frame = 1; world.getTime() < seconds; ++frame) {
+        int64_t frameTime = (int64_t) (frame * dt * 1e9);
+        if (run.stopBursts > 0.0 && play.stopped > seconds && world.getTime() >= run.stopBursts) {
+            WaveSettings stop = waves;
+            stop.burstInterval = 0.0f;
+            world.setWaves(stop);
+            play.stopped = world.getTime();
+        }
+        if (run.autopilot) { pilot.act(world, frameTime); }
+        // The last step lands on the end exactly, so every run resumes
+        // the timers due by then and no others
+        world.step(fmin(dt, seconds - world.getTime()), frameTime);
+        if (world.getMemoryStats().refused > 0 && world.getTime() - 1.0 < play.cutoff) {
+            play.cutoff = world.getTime() - 1.0;
+        }
+    }
+
+    play.spawns = recorder.spawns;
+    play.resumes = world.getWaveResumes();
+    play.refused = world.getMemoryStats().refused;
+}
+
+// Whether the run launched the expected meteors after the start time up to
+// the cutoff, no more and no fewer
+static bool isSameSpawns(const std::vector<Spawn>& spawns, const std::vector<Spawn>& expected,
+    double start, double cutoff, bool shapes) {
+    size_t i = 0, j = 0;
+    while (i < spawns.size() && spawns[i].time <= start) { ++i; }
+    while (j < expected.size() && expected[j].time <= start) { ++j; }
+    for (; j < expected.size() && expected[j].time <= cutoff; ++i, ++j) {
+        if (i >= spawns.size() || !isSameSpawn(spawns[i], expected[j], shapes)) { return false; }
+    }
+    return i >= spawns.size() || spawns[i].time > cutoff;
+}
+
+// Switches the bursts off in the middle of a burst and between two, where
+// the task waits out the interval. Up to the switch the run must match one
+// with bursts, after it one without: no burst meteor may follow the switch.
+// Burst meteors take shapes from the same sequence as the stream, so after
+// the switch only the launches are compared.
+static int verifyBurstStop(unsigned seed, const WaveSettings& waves) {
+    WaveSettings bursts = waves;
+    if (bursts.burstInterval <= 0.0f) { bursts.burstInterval = 10.0f; }
+    WaveSettings none = waves;
+    none.burstInterval = 0.0f;
+    double interval = bursts.burstInterval;
+    double seconds = interval * 4;
+
+    WavePlay on, off;
+    WaveRun plain = { 60.0, false, 0.0 };
+    playWaves(seed, bursts, plain, seconds, on);
+    playWaves(seed, none, plain, seconds, off);
+
+    const double stops[] = { interval * 2 + bursts.burstSpacing * 1.5, interval * 2.5 };
+    int failures = 0;
+    for (size_t s = 0; s < sizeof(stops) / sizeof(stops[0]); ++s) {
+        WaveRun run = { 60.0, false, stops[s] };
+        WavePlay play;
+        playWaves(seed, bursts, run, seconds, play);
+
+        double cutoff = fmin(play.cutoff, fmin(on.cutoff, off.cutoff));
+        bool same = isSameSpawns(play.spawns, on.spawns, -1.0, fmin(cutoff, play.stopped),
+            true) && isSameSpawns(play.spawns, off.spawns, play.stopped, cutoff, false);
+        if (!same) { failures++; }
+        LOGI("Bursts stopped at %.2f s: %u meteors, %d refused, %s", play.stopped,
+            (unsigned) play.spawns.size(), play.refused, same ? "same" : "different");
+        if (cutoff <= seconds) {
+            LOGI("Bursts compared up to %.1f s, meteors were refused after", cutoff);
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+// Plays a seed at several frame rates untouched, then again with the
+// autopilot shooting. Every run must launch the same meteors, shapes
+// included, at the same times, and resume the wave tasks as often whatever
+// the frame rate, so frames between spawns cost nothing. Meteor caps are
+// raised so nothing should be refused. If a spawn still is, the runs are
+// compared up to a second before the first refusal, since which spawns
+// get in after it depends on when frames free a slot.
+static int verifyWaves(unsigned seed, const WaveSettings& waves) {
+    const double seconds = 240.0;
+    // The last two replay the first
+    const WaveRun runs[] = { { 60.0, false, 0.0 }, { 30.0, false, 0.0 }, { 144.0, false, 0.0 },
+        { 60.0, false, 0.0 }, { 60.0, true, 0.0 } };
+    const int runCount = sizeof(runs) / sizeof(runs[0]);
+    WavePlay plays[runCount];
+    double cutoff = seconds + 1.0;
+
+    for (int r = 0; r < runCount; ++r) {
+        playWaves(seed, waves, runs[r], seconds, plays[r]);
+        cutoff = fmin(cutoff, plays[r].cutoff);
+    }
+
+    int failures = 0;
+    for (int r = 0; r < runCount; ++r) {
+        bool same = isSameSpawns(plays[r].spawns, plays[0].spawns, -1.0, cutoff, true) &&
+            plays[r].resumes == plays[0].resumes;
+        if (!same) { failures++; }
+
+        LOGI("Waves at %.0f fps%s: %u meteors, %u resumes, %d refused, %s", runs[r].fps,
+            runs[r].autopilot ? " with the autopilot" : "", (unsigned) plays[r].spawns.size(),
+            plays[r].resumes, plays[r].refused, same ? "same" : "different");
+    }
+    if (cutoff <= seconds) {
+        LOGI("Waves compared up to %.1f s, meteors were refused after", cutoff);
+    }
+
+    return (failures == 0 ? 0 : 1) | verifyBurstStop(seed, waves);
+}
+
+// Checks every compiled in kernel variant against the scalar reference
+static int verifyKernels() {
+    const GeometryKernels* variants[] = { neonKernels, sse4Kernels, avx2Kernels };
+    int mismatches = 0;
+
+    for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); ++v) {
+        if (variants[v] == NULL) { continue; }
+        const GeometryKernels& kernels = *variants[v];
+        int failed = mismatches;
+
+        for (int test = 0; test < 10000; ++test) {
+            int count = 1 + (int) (scriptRandom() * 15);
+            int16_t a[32];
+            for (int i = 0; i < count * 2; ++i) { a[i] = quantizePosition(scriptRandom() * 2 - 1); }
+            float sx = scriptRandom() * 2 + 0.01f, sy = scriptRandom() * 2 + 0.01f;
+
+            float boxA[4], boxB[4];
+            scalarKernels.bounds(a, count, sx, sy, boxA);
+            kernels.bounds(a, count, sx, sy, boxB);
+            if (memcmp(boxA, boxB, sizeof(boxA)) != 0) { mismatches++; }
+
+            float ox = scriptRandom() - 0.5f, oy = scriptRandom() - 0.5f;
+            float x = scriptRandom() * 2 - 1, y = scriptRandom() * 2 - 1;
+            if (scalarKernels.isInside(a, count, sx, sy, ox, oy, x, y) !=
+                kernels.isInside(a, count, sx, sy, ox, oy, x, y)) {
+                mismatches++;
+            }
+        }
+        LOGI("Kernels %s: %d mismatches", kernels.name, mismatches - failed);
+    }
+
+    return (mismatches == 0 ? 0 : 1) | verifyQuantization() | verifyOutlines();
+}
+
+// Times spawn bursts of one meteor and its four small ones, made on the
+// spot or popped from the worker's rings, with a frame of idle time between
+static void benchShapes(int bursts, bool async) {
+    ShapeFactory shapes(1);
+    if (async) { shapes.startWorker(); }
+
+    int16_t vertices[MAX_VERTEX_COUNT * DIMENTIONS];
+    struct timespec frame = { 0, 16000000 / 16 };
+    int64_t busy = 0;
+    for (int burst = 0; burst < bursts; ++burst) {
+        nanosleep(&frame, NULL);
+
+        int64_t start = monotonicNanos();
+        for (int i = 0; i < 5; ++i) {
+            int count = (int) (scriptRandom() * (MAX_VERTEX_COUNT - MIN_VERTEX_COUNT)) + MIN_VERTEX_COUNT;
+            if (count >= MAX_VERTEX_COUNT) { count = MAX_VERTEX_COUNT - 1; }
+            shapes.take(SHAPES_METEOR, count, vertices);
+        }
+        busy += monotonicNanos() - start;
+        shapes.refill();
+    }
+
+    LOGI("Shapes %s: %.0f ns per shape, %u popped, %u made on spawn",
+        async ? "with worker" : "on spawn", (double) busy / (bursts * 5),
+        shapes.getTaken(), shapes.getMade());
+}
+
+// Keeps about count particles alive, bursting from random points, and
+// times the update pass
+static void benchParticles(int count, int frames, double dt) {
+    ParticleSystem particles(count);
+    // A burst lives about a second, so refill at that rate
+    int perFrame = (int) (count * dt) + 1;
+
+    int64_t busy = 0;
+    long long updated = 0;
+    for (int frame = 0; frame < frames; ++frame) {
+        particles.emit(scriptRandom() - 0.5f, scriptRandom(), perFrame, 0.5f);
+
+        int64_t start = monotonicNanos();
+        particles.step(dt);
+        busy += monotonicNanos() - start;
+        updated += particles.getCount();
+    }
+
+    LOGI("Particles: peak %d, %.1f us per frame, %.2f ns per particle",
+        particles.getPeak(), busy / 1e3 / frames, (double) busy / updated);
+}
+
+// Drives the frame pacer on a simulated 60 Hz display whose frames take a
+// varying time to render, with a long stall now and then and a static
+// screen held for half a second. Fails if the pacer misses the target rate
+// or the game time drifts from the wall clock.
+static int benchPacer(int targetFps, int frames) {
+    const int64_t vsync = 1000000000LL / 60;
+    ManualClock clock;
+    FramePacer pacer(&clock);
+    pacer.setTargetFps(targetFps);
+
+    double simulated = 0.0;
+    double maxDt = 0.0;
+    double maxStep = 0.0;
+    double lastDt = 0.0;
+    int64_t start = 0;
+    int64_t wakeups = 0;
+    bool held = false;
+    for (int frame = 0; frame < frames; ) {
+        wakeups++;
+        if (!pacer.isFrameDue(true)) {
+            // Block in the event loop for as long as the pacer allows
+            int timeout = pacer.getTimeout(true);
+            clock.advance(timeout > 0 ? timeout * 1000000LL : 1000000LL);
+            continue;
+        }
+
+        double dt = pacer.beginFrame();
+        if (frame == 0) { start = clock.now(); }
+        simulated += dt;
+        // The frame after a hold steps all of it, the filter is for the rest
+        if (!held) {
+            if (dt > maxDt) { maxDt = dt; }
+            if (frame > 1 && fabs(dt - lastDt) > maxStep) { maxStep = fabs(dt - lastDt); }
+            lastDt = dt;
+        }
+        held = false;
+        frame++;
+
+        // Render for 4 to 12 ms, stall for 80 ms every 500 frames
+        int64_t render = (int64_t) ((4.0 + 8.0 * scriptRandom()) * 1e6);
+        if (frame % 500 == 0) { render = 80000000LL; }
+        clock.advance(render);
+        // The swap returns at the next vsync
+        clock.advance(vsync - clock.now() % vsync);
+
+        if (frame % 700 == 0) {
+            pacer.hold(500000000LL);
+            held = true;
+        }
+    }
+    double wall = (clock.now() - start) / 1e9;
+
+    double expected = targetFps > 0 && targetFps < 60 ? targetFps : 60.0;
+    pacer.log("Pacer");
+    LOGI("Pacer: %.1f s simulated in %.1f s, dt at most %.1f ms, changes at most %.2f ms, "
+        "%.2f wakeups per frame", simulated, wall, maxDt * 1e3, maxStep * 1e3,
+        (double) wakeups / frames);
+
+    int errors = 0;
+    if (fabs(pacer.getFps() - expected) > expected * 0.05) {
+        LOGE("Pacer missed %.0f fps", expected);
+        errors++;
+    }
+    if (fabs(simulated - wall) > wall * 0.02) {
+        LOGE("Game time drifted from the wall clock");
+        errors++;
+    }
+    return errors > 0 ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    int frames = 100000;
+    unsigned seed = 1;
+    double fps = 60.0;
+    bool verify = false;
+    bool async = false;
+    int shapeBursts = 0;
+    int debris = -1;
+    int particles = 0;
+    bool autopilot = false;
+    const char* trace = NULL;
+    bool checkAllocs = false;
+    int batch = 0;
+    int threads = 0;
+    std::vector<float> spawnRates;
+    WaveSettings waves;
+    bool verifyWaveReplay = false;
+    int pace = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            fps = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--verify-kernels") == 0) {
+            verify = true;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace = argv[++i];
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--spawn-rate") == 0 && i + 1 < argc) {
+            // A comma separated list sweeps the rates across a batch
+            for (char* rate = strtok(argv[++i], ","); rate != NULL; rate = strtok(NULL, ",")) {
+                spawnRates.push_back(atof(rate));
+            }
+        } else if (strcmp(argv[i], "--curve") == 0 && i + 1 < argc) {
+            if (!waves.parseCurve(argv[++i])) {
+                LOGE("A curve is TIME:RATE[,TIME:RATE...], not %s", argv[i]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--bursts") == 0 && i + 1 < argc) {
+            // Interval, then optionally size and spacing, 0 for none
+            char* burst = strtok(argv[++i], ",");
+            waves.burstInterval = atof(burst);
+            if ((burst = strtok(NULL, ",")) != NULL) { waves.burstSize = atoi(burst); }
+            if ((burst = strtok(NULL, ",")) != NULL) { waves.burstSpacing = atof(burst); }
+        } else if (strcmp(argv[i], "--verify-waves") == 0) {
+            verifyWaveReplay = true;
+        } else if (strcmp(argv[i], "--pace") == 0 && i + 1 < argc) {
+            pace = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--check-allocs") == 0) {
+            checkAllocs = true;
+        } else if (strcmp(argv[i], "--autopilot") == 0) {
+            autopilot = true;
+        } else if (strcmp(argv[i], "--async-shapes") == 0) {
+            async = true;
+        } else if (strcmp(argv[i], "--shapes") == 0 && i + 1 < argc) {
+            shapeBursts = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--debris") == 0 && i + 1 < argc) {
+            debris = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--particles") == 0 && i + 1 < argc) {
+            particles = atoi(argv[++i]);
+        } else {
+            LOGE("Usage: %s [--frames N] [--seed N] [--fps N] [--async-shapes] [--debris N]\n"
+                "       %*s [--autopilot] [--trace FILE] [--check-allocs] [--spawn-rate R]\n"
+                "       %*s [--curve T:R,T:R...] [--bursts INTERVAL[,SIZE[,SPACING]]]\n"
+                "       %s --batch GAMES [--threads N] [--spawn-rate R,R...] [--frames LIMIT]\n"
+                "       %s --verify-kernels | --verify-waves | --shapes BURSTS | --particles COUNT\n"
+                "       %s --pace FPS",
+                argv[0], (int) strlen(argv[0]), "", (int) strlen(argv[0]), "", argv[0], argv[0],
+                argv[0]);
+            return 2;
+        }
+    }
+
+#if !GUNNER_ALLOC_TRACKING
+    if (checkAllocs) {
+        LOGE("Allocations are not tracked, build with GUNNER_ALLOC_TRACKING on");
+        return 2;
+    }
+#endif
+
+    initKernels();
+    if (verify) { return verifyKernels(); }
+    if (verifyWaveReplay) { return verifyWaves(seed, waves); }
+    if (shapeBursts > 0) {
+        benchShapes(shapeBursts, false);
+        benchShapes(shapeBursts, true);
+        return 0;
+    }
+
+    scriptState = seed;
+    if (pace >= 0) { return benchPacer(pace, frames < 10000 ? frames : 10000); }
+    double dt = 1.0 / fps;
+    if (particles > 0) {
+        benchParticles(particles, frames, dt);
+        return 0;
+    }
+    int64_t frameNanos = (int64_t) (dt * 1e9);
+
+    if (trace != NULL && !traceStart(trace)) { return 1; }
+    traceThreadName("bench");
+
+    if (batch > 0) {
+        BatchSettings settings;
+        settings.games = batch;
+        settings.seed = seed;
+        settings.threads = threads;
+        settings.dt = dt;
+        settings.maxFrames = frames;
+        settings.autopilot = autopilot;
+        settings.debris = debris;
+        settings.spawnRates = spawnRates;
+        settings.waves = waves;
+
+        BatchRunner runner(settings);
+        bool ran = runner.run();
+        traceStop();
+        if (!ran) { return 1; }
+        runner.log();
+        return 0;
+    }
+
+    float spawnRate = spawnRates.empty() ? 1.0f : spawnRates[0];
+    World* world = new World(0.6f, seed);
+    if (async) { world->getShapes().startWorker(); }
+    if (debris >= 0) { world->setDebris(debris); }
+    world->setWaves(waves);
+    world->setSpawnRate(spawnRate);
+    int peakParticles = 0;
+    Autopilot pilot;
+    int64_t pilotNanos = 0;
+    int games = 1;
+    long long totalScore = 0;
+    int bestScore = 0;
+    size_t peakBytes = 0;
+    // Frames of the current game, and the checked ones that allocated
+    int gameFrames = 0;
+    int allocatingFrames = 0;
+
+    int64_t start = monotonicNanos();
+    for (int frame = 1; frame <= frames; ++frame) {
+        int64_t frameTime = frame * frameNanos;
+        bool checkFrame = checkAllocs && ++gameFrames > ALLOC_WARMUP_FRAMES;
+        uint64_t allocations = checkFrame ? allocThreadCount() : 0;
+
+        if (autopilot) {
+            int64_t pilotStart = monotonicNanos();
+            pilot.act(*world, frameTime);
+            pilotNanos += monotonicNanos() - pilotStart;
+        } else if (scriptRandom() < 4.0 * dt) {
+            // A few taps a second, stamped somewhere within the last frame
+            float x = scriptRandom() * 1.2f - 0.6f;
+            world->getInput().push(x, 0.0f, frameTime - (int64_t) (scriptRandom() * frameNanos));
+        }
+
+        world->step(dt, frameTime);
+        if (checkFrame && allocThreadCount() != allocations) {
+            if (allocatingFrames == 0) {
+                LOGE("Frame %d of game %d allocated %llu times", gameFrames, games,
+                    (unsigned long long) (allocThreadCount() - allocations));
+            }
+            allocatingFrames++;
+        }
+
+        if (world->isOver()) {
+            totalScore += world->getScore();
+            if (world->getScore() > bestScore) { bestScore = world->getScore(); }
+            if (world->getMemoryStats().peakBytes > peakBytes) {
+                peakBytes = world->getMemoryStats().peakBytes;
+            }
+            if (world->getParticles().getPeak() > peakParticles) {
+                peakParticles = world->getParticles().getPeak();
+            }
+            delete world;
+            world = new World(0.6f, seed + games);
+            if (async) { world->getShapes().startWorker(); }
+            if (debris >= 0) { world->setDebris(debris); }
+            world->setWaves(waves);
+            world->setSpawnRate(spawnRate);
+            games++;
+            gameFrames = 0;
+        }
+    }
+    int64_t elapsed = monotonicNanos() - start;
+    traceStop();
+
+    totalScore += world->getScore();
+    if (world->getScore() > bestScore) { bestScore = world->getScore(); }
+    if (world->getMemoryStats().peakBytes > peakBytes) {
+        peakBytes = world->getMemoryStats().peakBytes;
+    }
+    if (world->getParticles().getPeak() > peakParticles) {
+        peakParticles = world->getParticles().getPeak();
+    }
+    delete world;
+
+    double seconds = elapsed / 1e9;
+    LOGI("Frames: %d in %.3f s, %.0f sim frames/s", frames, seconds, frames / seconds);
+    LOGI("Games: %d, total score %lld, best score %d", games, totalScore, bestScore);
+    LOGI("Peak memory: %u bytes, peak particles %d", (unsigned) peakBytes, peakParticles);
+    if (autopilot) {
+        LOGI("Autopilot: %.0f ns per frame", (double) pilotNanos / frames);
+    }
+    if (checkAllocs) {
+        AllocCounters totals = allocTotals();
+        LOGI("Allocations: %llu in total, %llu bytes, %d steady frames allocated",
+            (unsigned long long) totals.allocations, (unsigned long long) totals.bytes,
+            allocatingFrames);
+        if (allocatingFrames > 0) {
+            allocLogSites();
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -1,40 +1,46 @@
-#ifndef BULLET_CPP
-#define BULLET_CPP
+#include "bullet.h"
 
-#include <GLES2/gl2.h>
-#include "node.cpp"
+#include <math.h>
+#include <stdlib.h>
 
-class Bullet: public Node {
+const float Bullet::speed = 0.7f;
+const float Bullet::startY = -0.6f;
 
-    static const float speed = 0.7f;
+Bullet::Bullet()
+    : launchTime_(0.0), tapTime_(0)
+{
+    vertexCount_ = 4;
 
-public:
-    Bullet();
-    NodeType getType() { return BULLET; };
-    bool isIntersect(Node* node);
-    float getSpeed() { return speed; }
-};
+    vertices_ = vertexStorage_;
+    vertices_[0] = quantizePosition(0.0f);    vertices_[1] = quantizePosition(1.0f);
+    vertices_[2] = quantizePosition(-0.4f);   vertices_[3] = quantizePosition(0.0f);
+    vertices_[4] = quantizePosition(0.0f);    vertices_[5] = quantizePosition(-1.0f);
+    vertices_[6] = quantizePosition(0.4f);    vertices_[7] = quantizePosition(0.0f);
 
-Bullet::Bullet() {
-    vertexCount_ = 4;
+    colors_ = colorStorage_;
+    fillColor(colors_, vertexCount_, 0.2078f, 1.0f, 1.0f, 1.0f);
+
+    scale(0.04f, 0.04f);
+    y_ = startY;
+}
 
-    vertices_ = new GLfloat[vertexCount_ * DIMENTIONS];
-    vertices_[0] = 0.0f;    vertices_[1] = 1.0f;
-    vertices_[2] = -0.4f;   vertices_[3] = 0.0f;
-    vertices_[4] = 0.0f;    vertices_[5] = -1.0f;
-    vertices_[6] = 0.4f;    vertices_[7] = 0.0f;
+// Fires the bullet upwards from x at the given simulation time
+void Bullet::launch(float x, double time) {
+    x_ = x;
+    y_ = startY;
+    launchTime_ = time;
+}
 
-    colors_ = new GLfloat[vertexCount_ * COLOR_COMPONENTS];
+void Bullet::updateAt(double time) {
+    y_ = startY + speed * (float) (time - launchTime_);
+}
 
-    for(int i = 0; i < vertexCount_ * COLOR_COMPONENTS; i+=COLOR_COMPONENTS ) {
-        colors_[i] = 0.2078f;
-        colors_[i + 1] = 1.0f;
-        colors_[i + 2] = 1.0f;
-        colors_[i + 3] = 1.0;
-    }
+// The moment the bullet flies off the top edge
+double Bullet::getExitTime() {
+    float xmin, xmax, ymin, ymax;
+    getBounds(xmin, xmax, ymin, ymax);
 
-    scale(0.04f, 0.04f);
-    y_ = -0.6f;
+    return launchTime_ + fmax((YMAX - startY - ymin) / speed, 0.0f);
 }
 
 bool Bullet::isIntersect(Node* node) {
@@ -42,8 +48,8 @@ bool Bullet::isIntersect(Node* node) {
         return false;
     }
 
-    float x = vertices_[0] + x_, y = vertices_[1] + y_;
-    return node->isInside(x, y);
+    // The tip is the first vertex
+    float x, y;
+    getVertex(0, x, y);
+    return node->isInside(x + x_, y + y_);
 }
-
-#endif
\ No newline at end of file
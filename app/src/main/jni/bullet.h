@@ -0,0 +1,33 @@
+#ifndef BULLET_H
+#define BULLET_H
+
+#include <stdint.h>
+
+#include "node.h"
+
+class Bullet: public Node {
+
+    static const float speed;
+    static const float startY;
+    int16_t vertexStorage_[4 * DIMENTIONS];
+    uint8_t colorStorage_[4 * COLOR_COMPONENTS];
+    double launchTime_;
+    int64_t tapTime_;
+
+public:
+    Bullet();
+    NodeType getType() { return BULLET; };
+    size_t getFootprint() { return sizeof(*this); };
+    bool isIntersect(Node* node);
+    static float getSpeed() { return speed; }
+    // Height bullets are fired from
+    static float getStartY() { return startY; }
+    void launch(float x, double time);
+    void updateAt(double time);
+    double getExitTime();
+    // Time stamp of the tap that fired the bullet, 0 once it has been shown
+    int64_t getTapTime() { return tapTime_; }
+    void setTapTime(int64_t time) { tapTime_ = time; }
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include "eventQueue.h"
+
+using namespace std;
+
+void EventQueue::place(int index, const Event& event) {
+    heap_[index] = event;
+    event.node->setEventIndex(event.type, index);
+}
+
+void EventQueue::siftUp(int index) {
+    Event event = heap_[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (heap_[parent].time <= event.time) { break; }
+        place(index, heap_[parent]);
+        index = parent;
+    }
+    place(index, event);
+}
+
+void EventQueue::siftDown(int index) {
+    Event event = heap_[index];
+    int count = heap_.size();
+    while (true) {
+        int child = index * 2 + 1;
+        if (child >= count) { break; }
+        if (child + 1 < count && heap_[child + 1].time < heap_[child].time) { ++child; }
+        if (event.time <= heap_[child].time) { break; }
+        place(index, heap_[child]);
+        index = child;
+    }
+    place(index, event);
+}
+
+void EventQueue::removeAt(int index) {
+    heap_[index].node->setEventIndex(heap_[index].type, -1);
+
+    int last = heap_.size() - 1;
+    if (index != last) {
+        Event moved = heap_[last];
+        place(index, moved);
+        heap_.pop_back();
+        siftDown(index);
+        siftUp(moved.node->getEventIndex(moved.type));
+    } else {
+        heap_.pop_back();
+    }
+}
+
+// Sets the time of node's event of the given type, replacing the old one
+void EventQueue::schedule(Node* node, EventType type, double time) {
+    int index = node->getEventIndex(type);
+    if (index >= 0) { removeAt(index); }
+
+    Event event = { time, node, type };
+    heap_.push_back(event);
+    siftUp(heap_.size() - 1);
+}
+
+void EventQueue::cancel(Node* node) {
+    for (int type = 0; type < EVENT_TYPES; ++type) {
+        int index = node->getEventIndex((EventType) type);
+        if (index >= 0) { removeAt(index); }
+    }
+}
+
+// Takes the earliest event if it is due by now
+bool EventQueue::pop(double now, Event& event) {
+    if (heap_.empty() || heap_[0].time > now) { return false; }
+
+    event = heap_[0];
+    removeAt(0);
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <vector>
+
+#include "node.h"
+
+struct Event {
+    double time;
+    Node* node;
+    EventType type;
+};
+
+// Binary min-heap of predicted entity events ordered by simulation time.
+// Every node remembers where its events sit, so they can be rescheduled
+// or cancelled in O(log n) when the node dies early.
+class EventQueue {
+    std::vector<Event> heap_;
+
+    void place(int index, const Event& event);
+    void siftUp(int index);
+    void siftDown(int index);
+    void removeAt(int index);
+
+public:
+    void schedule(Node* node, EventType type, double time);
+    void cancel(Node* node);
+    bool pop(double now, Event& event);
+    int size() { return heap_.size(); }
+    size_t getCapacityBytes() { return heap_.capacity() * sizeof(Event); }
+    void reserve(int count) { heap_.reserve(count); }
+};
+
+#endif
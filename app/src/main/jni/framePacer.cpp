@@ -0,0 +1,131 @@
+#include "framePacer.h"
+
+#include <algorithm>
+#include <math.h>
+
+#include "util.h"
+
+using namespace std;
+
+// Longest step a single frame can make, a stall beyond it is dropped
+const double FramePacer::maxDt = 0.1;
+// Weight of the newest frame time in the filtered dt
+const double FramePacer::smoothing = 0.1;
+// Share of the owed time paid back every frame
+const double FramePacer::driftCorrection = 0.1;
+const int64_t FramePacer::slack = 2000000;
+
+int64_t MonotonicClock::now() {
+    return monotonicNanos();
+}
+
+FramePacer::FramePacer(Clock* clock)
+    : clock_(clock), interval_(0), lastFrame_(0), nextFrame_(0), frameTime_(0),
+    idle_(false), dirty_(false), holdUntil_(0), held_(false)
+{
+    restart();
+    resetStats();
+}
+
+void FramePacer::setTargetFps(int fps) {
+    interval_ = fps > 0 ? 1000000000LL / fps : 0;
+}
+
+void FramePacer::setIdle(bool idle) {
+    idle_ = idle;
+    // Time that passed while idle isn't simulated
+    if (!idle) { restart(); }
+}
+
+void FramePacer::hold(int64_t nanos) {
+    holdUntil_ = clock_->now() + nanos;
+    held_ = true;
+}
+
+void FramePacer::restart() {
+    started_ = false;
+    smoothDt_ = 0.0;
+    drift_ = 0.0;
+}
+
+int FramePacer::getTimeout(bool active) {
+    if (!active || (idle_ && !dirty_)) { return -1; }
+
+    int64_t due = interval_ == 0 ? holdUntil_ : max(nextFrame_, holdUntil_);
+    int64_t wait = due - slack - clock_->now();
+    if (wait <= 0) { return 0; }
+    return (int) ((wait + 999999) / 1000000);
+}
+
+bool FramePacer::isFrameDue(bool active) {
+    if (!active || (idle_ && !dirty_)) { return false; }
+    int64_t now = clock_->now();
+    if (now < holdUntil_ - slack) { return false; }
+    return interval_ == 0 || now >= nextFrame_ - slack;
+}
+
+double FramePacer::beginFrame() {
+    int64_t now = clock_->now();
+    frameTime_ = now;
+    dirty_ = false;
+    bool held = held_;
+    holdUntil_ = 0;
+    held_ = false;
+
+    // Keep the phase of the target rate unless a whole frame was missed
+    nextFrame_ = nextFrame_ + interval_ > now ? nextFrame_ + interval_ : now + interval_;
+
+    if (!started_) {
+        started_ = true;
+        lastFrame_ = now;
+        return 0.0;
+    }
+    double raw = (now - lastFrame_) / 1e9;
+    lastFrame_ = now;
+
+    // Nothing moved during a hold, so it is stepped whole and left out of
+    // the filter and the statistics like a pause
+    if (held && !idle_) { return raw; }
+
+    frames_++;
+    sum_ += raw * 1e3;
+    sumSquares_ += raw * 1e3 * raw * 1e3;
+
+    // A screen that doesn't move needs no time
+    if (idle_) { return 0.0; }
+
+    // Follow the frame time slowly, paying back what the filter held back
+    // or added so the game keeps up with the wall clock over time
+    raw = fmin(raw, maxDt);
+    smoothDt_ = smoothDt_ == 0.0 ? raw : smoothDt_ + (raw - smoothDt_) * smoothing;
+    double dt = fmax(smoothDt_ + drift_ * driftCorrection, 0.0);
+    drift_ += raw - dt;
+    return dt;
+}
+
+double FramePacer::getFps() {
+    return sum_ > 0.0 ? frames_ * 1e3 / sum_ : 0.0;
+}
+
+double FramePacer::getMeanFrameTime() {
+    return frames_ == 0 ? 0.0 : sum_ / frames_;
+}
+
+double FramePacer::getFrameTimeVariance() {
+    if (frames_ == 0) { return 0.0; }
+    double mean = sum_ / frames_;
+    return fmax(sumSquares_ / frames_ - mean * mean, 0.0);
+}
+
+void FramePacer::resetStats() {
+    frames_ = 0;
+    sum_ = 0.0;
+    sumSquares_ = 0.0;
+}
+
+void FramePacer::log(const char* name) {
+    if (frames_ == 0) { return; }
+
+    LOGI("%s: %.1f fps, frame time mean %.2f ms, variance %.2f ms^2, deviation %.2f ms",
+        name, getFps(), getMeanFrameTime(), getFrameTimeVariance(), sqrt(getFrameTimeVariance()));
+}
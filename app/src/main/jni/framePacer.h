@@ -0,0 +1,92 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <stdint.h>
+
+// Where the pacer gets its time from, in nanoseconds
+class Clock {
+public:
+    virtual ~Clock() {};
+    virtual int64_t now() = 0;
+};
+
+// CLOCK_MONOTONIC, the clock input events are stamped with
+class MonotonicClock: public Clock {
+public:
+    int64_t now();
+};
+
+// Time that only moves when told to, for driving the pacer headless
+class ManualClock: public Clock {
+    int64_t time_;
+
+public:
+    ManualClock() : time_(0) {};
+    int64_t now() { return time_; }
+    void advance(int64_t nanos) { time_ += nanos; }
+};
+
+// Decides when the event loop draws a frame and how much simulation time
+// it steps. Frames are held back to the target rate, dt is filtered so one
+// late swap doesn't jerk the game forward, and an idle screen draws only
+// when something invalidated it, so the loop can block on events instead.
+class FramePacer {
+    Clock* clock_;
+    // Nanoseconds between frames, 0 draws on every vsync
+    int64_t interval_;
+    bool started_;
+    int64_t lastFrame_;
+    int64_t nextFrame_;
+    int64_t frameTime_;
+    // Filtered frame time and the simulation time it still owes the wall clock
+    double smoothDt_;
+    double drift_;
+    bool idle_;
+    bool dirty_;
+    // No frame before this time unless invalidated, 0 for none
+    int64_t holdUntil_;
+    // The frame ends a hold, so it steps the whole of it
+    bool held_;
+
+    // Statistics of the raw frame times, pauses left out
+    unsigned frames_;
+    double sum_;
+    double sumSquares_;
+
+    static const double maxDt;
+    static const double smoothing;
+    static const double driftCorrection;
+    // Frames this early are drawn, the swap waits for vsync anyway
+    static const int64_t slack;
+
+public:
+    FramePacer(Clock* clock);
+    // 0 follows the display
+    void setTargetFps(int fps);
+    // Nothing moves on the screen, frames are drawn only when invalidated
+    void setIdle(bool idle);
+    bool isIdle() { return idle_; }
+    void invalidate() { dirty_ = true; holdUntil_ = 0; }
+    // The screen is static for the given time, e.g. until the next spawn.
+    // Unlike idle the time is simulated, in one step once the hold ends.
+    void hold(int64_t nanos);
+    // Forget the last frame, e.g. after a pause, so the next dt is 0
+    void restart();
+
+    // Milliseconds the event loop may block waiting for events, -1 for ever
+    int getTimeout(bool active);
+    bool isFrameDue(bool active);
+    // Starts a frame and returns its filtered dt in seconds
+    double beginFrame();
+    // Clock time of the frame begun last
+    int64_t getFrameTime() { return frameTime_; }
+
+    double getFps();
+    // Of the raw frame times, in milliseconds
+    double getMeanFrameTime();
+    double getFrameTimeVariance();
+    void resetStats();
+    void log(const char* name);
+};
+
+#endif
@@ -1,159 +1,46 @@
-#ifndef GAME_CPP
-#define GAME_CPP
+#include "game.h"
 
-#include <jni.h>
-#include <android/log.h>
-
-#include <GLES2/gl2.h>
-#include <GLES2/gl2ext.h>
-#include <JNIHelper.h>
-#include <android/input.h>
-#include <vecmath.h>
 #include <stdio.h>
-#include <stdlib.h>
-#include <math.h>
-#include <time.h>
-#include <vector>
-#include <algorithm>
-#include <string>
-#include <sstream>
+#include <sys/time.h>
 
-#include "util.cpp"
-#include "node.cpp"
-#include "shuttle.cpp"
-#include "meteor.cpp"
-#include "smallMeteor.cpp"
-#include "bullet.cpp"
+#include "util.h"
+#include "glUtil.h"
+#include "trace.h"
 
 using namespace ndk_helper;
 using namespace std;
 
-class Game {
-    GLuint gProgram_;
-    GLuint gaPositionHandle_;
-    GLuint gaColorHandle_;
-    GLuint guVeiwProjHandle_;
-
-    GLuint loadShader(GLenum shaderType, const char* pSource);
-    GLuint createProgram(const char* pVertexSource, const char* pFragmentSource);
-
-    Mat4 mProj_;
-    int width_;
-    int height_;
-    float smallMeteorX_;
-    float smallMeteorY_;
-    int score_;
-    bool isOver_;
-
-    Shuttle* shuttle_;
-    vector<Node*> scene_;
-    vector<int> deleted_;
-
-    static const int smallMeteors = 4;
-
-    void updateMeteor(double dt, vector<Node*>::iterator nodeIt);
-    void updateBullet(double dt, vector<Node*>::iterator nodeIt);
-
-public:
-    Game(int w, int h);
-    ~Game();
-    void work(double dt);
-    void tap(float x, float y);
-    bool isOver() { return isOver_; }
-    string getGameOverText();
-    int getScore() { return score_; }
-};
-
-const char gVertexShader[] =
-    "uniform highp mat4 uViewProj;\n"
-    "attribute vec2 aPosition;\n"
-    "attribute vec4 aColor;\n"
-    "varying vec4 vColor;\n"
-    "void main() {\n"
-    "  highp vec4 p = vec4(aPosition, 0, 1);\n"
-    "  vColor = aColor;\n"
-    "  gl_Position = uViewProj * p;\n"
-    "}\n";
-
-const char gFragmentShader[] =
-    "precision mediump float;\n"
-    "varying vec4 vColor;\n"
-    "void main() {\n"
-    "  gl_FragColor = vColor;\n"
-    "}\n";
-
-GLuint Game::loadShader(GLenum shaderType, const char* pSource) {
-    GLuint shader = glCreateShader(shaderType);
-    if (!shader) { return shader; }
-
-    glShaderSource(shader, 1, &pSource, NULL);
-    glCompileShader(shader);
-    GLint compiled = 0;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
-    if (compiled) { return shader; }
-
-    GLint infoLen = 0;
-    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLen);
-    if (!infoLen) { return shader; }
-
-    char* buf = (char*) malloc(infoLen);
-    if (buf) {
-        glGetShaderInfoLog(shader, infoLen, NULL, buf);
-        LOGE("Could not compile shader %d:\n%s\n", shaderType, buf);
-        free(buf);
-    }
-    glDeleteShader(shader);
-    shader = 0;
-
-    return shader;
-}
-
-GLuint Game::createProgram(const char* pVertexSource, const char* pFragmentSource) {
-    GLuint vertexShader = loadShader(GL_VERTEX_SHADER, pVertexSource);
-    if (!vertexShader) { return 0; }
-
-    GLuint pixelShader = loadShader(GL_FRAGMENT_SHADER, pFragmentSource);
-    if (!pixelShader) { return 0; }
-
-    GLuint program = glCreateProgram();
-    if (!program) { return program; }
-
-    glAttachShader(program, vertexShader);
-    checkGlError("glAttachShader");
-    glAttachShader(program, pixelShader);
-    checkGlError("glAttachShader");
-    glLinkProgram(program);
-    GLint linkStatus = GL_FALSE;
-    glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
-
-    if (linkStatus == GL_TRUE) { return program; }
-
-    GLint bufLength = 0;
-    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &bufLength);
-
-    if (bufLength) {
-        char* buf = (char*) malloc(bufLength);
-        if (buf) {
-            glGetProgramInfoLog(program, bufLength, NULL, buf);
-            LOGE("Could not link program:\n%s\n", buf);
-            free(buf);
-        }
-    }
-    glDeleteProgram(program);
-    program = 0;
-
-    return program;
-}
-
-Game::Game(int w, int h)
-    : score_(0), isOver_(false), width_(w), height_(h),
-    smallMeteorX_(0.0f), smallMeteorY_(0.0f)
+Game::Game(int w, int h, bool antialias)
+    : gProgram_(0), gMeteorProgram_(0), gParticleProgram_(0), gUpscaleProgram_(0), width_(w),
+    height_(h), antialias_(antialias), meteorRenderMode_(METEOR_RENDER_CPU), meteorBatch_(NULL),
+    outlineBatch_(NULL), particleBatch_(NULL), hud_(NULL), scaler_(NULL), target_(NULL),
+    gpuTimer_(NULL), world_(NULL)
 {
     printGLString("Version", GL_VERSION);
     printGLString("Vendor", GL_VENDOR);
     printGLString("Renderer", GL_RENDERER);
     printGLString("Extensions", GL_EXTENSIONS);
 
+    // Init random generator
+    struct timeval now;
+    gettimeofday(&now, NULL);
+
+    // Init scene objects
+    world_ = new World((float) width_ / (float) height_, now.tv_usec);
+    world_->setListener(this);
+    world_->getShapes().startWorker();
+    // At most one stamp per bullet, so a frame never grows it
+    shownTaps_.reserve(NODE_POOL_CAPACITY);
+
+    // Strokes are two pixels wide whatever glLineWidth the driver supports,
+    // the playfield is two units high
+    float pixel = 2.0f / h;
+    float fringe = antialias_ ? pixel : 0.0f;
+    // Made before any program, work() uses them even if the programs fail
+    outlineBatch_ = new OutlineBatch(pixel, fringe, (float) w / h);
+    hud_ = new Hud(w, h);
+    gpuTimer_ = new GpuTimer();
+
     // Init GLES
     LOGI("setupGraphics(%d, %d)", width_, height_);
     gProgram_ = createProgram(gVertexShader, gFragmentShader);
@@ -180,30 +67,98 @@ Game::Game(int w, int h)
                         0.0f, 0.0f, 0.0f, 0.0f,
                         0.0f, 0.0f, 0.0f, 1.0f};
     mProj_ = Mat4((float*)&ortho);
+    float outlineRange = outlineBatch_->getRange();
+    float range[16] = { outlineRange, 0.0f, 0.0f, 0.0f,
+                        0.0f, outlineRange, 0.0f, 0.0f,
+                        0.0f, 0.0f, 1.0f, 0.0f,
+                        0.0f, 0.0f, 0.0f, 1.0f };
+    mOutlineProj_ = mProj_ * Mat4(range);
+
+    gMeteorProgram_ = createProgram(gMeteorVertexShader, gFragmentShader);
+    if (gMeteorProgram_) {
+        meteorBatch_ = new MeteorBatch(gMeteorProgram_, mProj_, pixel, fringe);
+        meteorRenderMode_ = METEOR_RENDER_GPU;
+        world_->getMemoryBudget().setGpuStorage(meteorBatch_->getBufferBytes());
+    } else {
+        LOGE("Could not create meteor program, meteors are drawn on CPU.");
+    }
 
-    // Init random generator
-    struct timeval now;
-    gettimeofday(&now, NULL);
-    srand(now.tv_usec);
+    gParticleProgram_ = createProgram(gParticleVertexShader, gParticleFragmentShader);
+    if (gParticleProgram_) {
+        particleBatch_ = new ParticleBatch(gParticleProgram_, mProj_);
+    } else {
+        LOGE("Could not create particle program, debris is not drawn.");
+    }
+}
 
-    // Init scene objects
-    shuttle_ = new Shuttle();
-    scene_.push_back(shuttle_);
+void Game::setMeteorRenderMode(MeteorRenderMode mode) {
+    if (mode == METEOR_RENDER_GPU && meteorBatch_ == NULL) { return; }
+    meteorRenderMode_ = mode;
 }
 
-void Game::tap(float x, float y) {
-    Bullet* bullet = new Bullet();
-    bullet->translate(shuttle_->getX(), 0.0f);
-    scene_.push_back(bullet);
+void Game::setResolutionScaler(ResolutionScaler* scaler) {
+    delete target_;
+    target_ = NULL;
+    scaler_ = NULL;
+    glViewport(0, 0, width_, height_);
+    if (scaler == NULL) { return; }
 
-    float dx = x - shuttle_->getX();
-    dx = copysignf(1.0, dx) * fmin(shuttle_->getSpeed(), abs(dx));
+    if (!gUpscaleProgram_) {
+        gUpscaleProgram_ = createProgram(gUpscaleVertexShader, gUpscaleFragmentShader);
+    }
+    if (gUpscaleProgram_) {
+        target_ = new RenderTarget(gUpscaleProgram_, width_, height_, scaler->getMaxScale());
+    }
+    if (target_ == NULL || !target_->isComplete()) {
+        LOGE("Could not create render target, the scene is drawn at full resolution.");
+        delete target_;
+        target_ = NULL;
+        return;
+    }
+    if (!gpuTimer_->isAvailable()) {
+        LOGI("Frames are not timed, the scene is drawn at scale %.2f", scaler->getScale());
+    }
+
+    scaler_ = scaler;
+    world_->getMemoryBudget().setGpuStorage(target_->getBytes() +
+        (meteorBatch_ != NULL ? meteorBatch_->getBufferBytes() : 0));
+}
+
+// Meteors are uploaded and stroked in both modes so switching takes effect immediately
+void Game::onMeteorAdded(Meteor* meteor) {
+    if (meteorBatch_ != NULL) {
+        meteor->setBatchSlot(meteorBatch_->add(meteor));
+    }
+    meteor->setOutlineSlot(outlineBatch_->cache(meteor));
+}
 
-    shuttle_->translate(dx, 0.0f);
+void Game::onNodeRemoved(Node* node) {
+    enum NodeType type = node->getType();
+    if (type != METEOR && type != SMALL_METEOR) { return; }
+
+    if (meteorBatch_ != NULL) {
+        meteorBatch_->remove(((Meteor*) node)->getBatchSlot());
+    }
+    outlineBatch_->forget(((Meteor*) node)->getOutlineSlot());
 }
 
-void Game::work(double dt) {
-    dt = fmin(dt, 1.0f);
+void Game::work(double dt, int64_t frameTime) {
+    TRACE_SCOPE("Game::work");
+    shownTaps_.clear();
+
+    world_->step(dt, frameTime);
+    // Without its program nothing can be drawn, the world still plays
+    if (!gProgram_) { return; }
+
+    // Frames the GPU finished by now pick the scale of this one
+    double gpuTime;
+    float drawnScale;
+    while (gpuTimer_->poll(gpuTime, drawnScale)) {
+        if (scaler_ != NULL) { scaler_->addFrame(gpuTime, drawnScale); }
+    }
+    float scale = scaler_ != NULL ? scaler_->getScale() : 1.0f;
+    gpuTimer_->begin(scale);
+    if (target_ != NULL) { target_->bind(scale); }
 
     // Clear some buffers
     glClearColor(0.2353f, 0.2471f, 0.2549f, 1.0f);
@@ -214,127 +169,69 @@ void Game::work(double dt) {
     glUseProgram(gProgram_);
     checkGlError("glUseProgram");
 
-    glLineWidth(2.0f);
-
-    // Randomly generate meteors at approximate rate one per second
-    if ( ((float)rand() / RAND_MAX) < dt ) {
-        Meteor* meteor = new Meteor();
-        float sky = (float) width_ / (float)height_;
-        float x = ((float)rand() / RAND_MAX) * sky  - sky / 2;
-        meteor->translate(x, 1.0f);
-        meteor->updateXSpeed();
-        scene_.push_back(meteor);
-    }
-
+    TRACE_SCOPE("render");
     // Render scene loop
-    for (vector<Node*>::iterator node = scene_.begin(); node < scene_.end(); ++node) {
-        // Let's draw it
-        (*node)->draw(dt, gaPositionHandle_, gaColorHandle_, guVeiwProjHandle_, mProj_);
-
+    outlineBatch_->clear();
+    const vector<Node*>& scene = world_->getScene();
+    for (vector<Node*>::const_iterator node = scene.begin(); node < scene.end(); ++node) {
         enum NodeType type = (*node)->getType();
 
-        // If it is a meteor than update it's position and stuff
-        if (type == METEOR || type == SMALL_METEOR) {
-            updateMeteor(dt, node);
-        }
-
-        // Do the same for bullet
-        if (type == BULLET) {
-            updateBullet(dt, node);
+        // Let's draw it, unless the batch does it for us
+        if (meteorRenderMode_ == METEOR_RENDER_CPU ||
+            !(type == METEOR || type == SMALL_METEOR) ||
+            ((Meteor*) (*node))->getBatchSlot() < 0) {
+            outlineBatch_->add(*node);
         }
-    }
-
-    if (!deleted_.empty()) {
-        // Sort "deleted" array to be able remove elements in right order
-        sort(deleted_.begin(), deleted_.end());
-        // Remove duplicates
-        deleted_.erase( unique( deleted_.begin(), deleted_.end() ), deleted_.end() );
-    }
-    // Remove elements in backwards order
-    for (int i = deleted_.size() - 1; i >= 0; --i) {
-        int index = deleted_[i];
-        delete scene_[index];
-        scene_.erase(scene_.begin() + index);
-    }
-    // All useless elements are deleted so clear the "deleted array"
-    deleted_.clear();
 
-    // If flag is set than it's time to spawn small ones
-    // And if we hit meteor at (0, 0), well.. than it's a lucky shot
-    if (smallMeteorX_ || smallMeteorY_) {
-        for (int i = 0; i < smallMeteors; ++i) {
-            SmallMeteor* smallMeteor = new SmallMeteor(smallMeteorX_, smallMeteorY_);
-            scene_.push_back(smallMeteor);
+        // Remember taps whose bullet makes it to the screen for the first time
+        if (type == BULLET && ((Bullet*) (*node))->getTapTime() != 0) {
+            shownTaps_.push_back(((Bullet*) (*node))->getTapTime());
+            ((Bullet*) (*node))->setTapTime(0);
         }
-        // Clear the spawn flag
-        smallMeteorX_ = smallMeteorY_ = 0.0f;
     }
-}
-
-void Game::updateMeteor(double dt, vector<Node*>::iterator nodeIt) {
-    Meteor* meteor = (Meteor*) (*nodeIt);
-    // Move meteor
-    meteor->translate(meteor->getXFallSpeed(), dt * meteor->getYFallSpeed());
-    // Make it spin
-    meteor->rotate(meteor->getRotateSpeed());
 
-    // Mark it for deletion if it's out
-    if (meteor->isOut()) {
-        deleted_.push_back(nodeIt - scene_.begin());
+    if (antialias_) {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     }
-
-    // If meteor hit shuttle than the game is over
-    if (shuttle_->isIntersect(meteor)) {
-        isOver_ = true;
+    // Nodes drawn on the CPU go in one draw
+    glUniformMatrix4fv(guVeiwProjHandle_, 1, GL_FALSE, mOutlineProj_.Ptr());
+    checkGlError("glUniformMatrix4fv");
+    outlineBatch_->draw(gaPositionHandle_, gaColorHandle_);
+
+    // All batched meteors go in one draw with a single uniform update
+    if (meteorRenderMode_ == METEOR_RENDER_GPU) {
+        meteorBatch_->draw(world_->getTime());
     }
-}
-
-void Game::updateBullet(double dt, vector<Node*>::iterator nodeIt) {
-    Bullet* bullet = (Bullet*) (*nodeIt);
-    // Move the bullet up
-    bullet->translate(0.0f, dt * bullet->getSpeed());
+    glDisable(GL_BLEND);
 
-    // Mark it for deletion if it's out
-    if (bullet->isOut()) {
-        deleted_.push_back(nodeIt - scene_.begin());
+    if (particleBatch_ != NULL) {
+        particleBatch_->draw(world_->getParticles(), scale);
     }
+    if (target_ != NULL) { target_->present(); }
+    glUseProgram(gProgram_);
 
-    // Detect if bullet hit meteor
-    for (vector<Node*>::iterator node = scene_.begin(); node < scene_.end(); ++node) {
-        enum NodeType type = (*node)->getType();
-
-        // And if it hit...
-        if ((type == METEOR || type == SMALL_METEOR) && bullet->isIntersect(*node)) {
-            // Remove the bullet
-            deleted_.push_back(nodeIt - scene_.begin());
-            // Remove the meteor
-            deleted_.push_back(node - scene_.begin());
-
-            // And if it is a big one set flag to spawn small meteors
-            if (type == METEOR) {
-                Meteor* meteor = (Meteor*) (*node);
-                smallMeteorX_ = meteor->getX();
-                smallMeteorY_ = meteor->getY();
-
-                score_++;
-            } else {
-                score_ += 2;
-            }
-        }
+    // Text geometry is only rebuilt when the score or the message changes
+    hud_->setScore(world_->getScore());
+    if (world_->isOver()) {
+        char text[HUD_MAX_TEXT];
+        snprintf(text, sizeof(text), "GAME OVER\nYOUR SCORE IS %d", world_->getScore());
+        hud_->setMessage(text);
     }
+    hud_->draw(gaPositionHandle_, gaColorHandle_, guVeiwProjHandle_);
+    gpuTimer_->end();
 }
 
-string Game::getGameOverText() {
-    stringstream ss;
-    ss << "GAME OVER" << endl << "Your score is " << score_;
-
-    return ss.str();
- }
-
 Game::~Game() {
-    for (vector<Node*>::iterator node = scene_.begin(); node < scene_.end(); ++node) {
-        delete (*node);
-    }
+    // The world hands its meteors back to the batch, so it goes first
+    delete world_;
+    delete meteorBatch_;
+    delete outlineBatch_;
+    delete particleBatch_;
+    delete hud_;
+    delete target_;
+    delete gpuTimer_;
+    if (gMeteorProgram_) { glDeleteProgram(gMeteorProgram_); }
+    if (gParticleProgram_) { glDeleteProgram(gParticleProgram_); }
+    if (gUpscaleProgram_) { glDeleteProgram(gUpscaleProgram_); }
 }
-
-#endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <GLES2/gl2.h>
+#include <vecmath.h>
+#include <stdint.h>
+#include <vector>
+
+#include "world.h"
+#include "meteorBatch.h"
+#include "outlineBatch.h"
+#include "hud.h"
+#include "particleBatch.h"
+#include "renderTarget.h"
+#include "gpuTimer.h"
+#include "resolutionScaler.h"
+
+enum MeteorRenderMode {
+    // Every meteor is moved on the CPU and drawn with its own transform
+    METEOR_RENDER_CPU,
+    // Meteors are uploaded once and animated in the vertex shader
+    METEOR_RENDER_GPU
+};
+
+// Renders the world with GLES2. The simulation itself lives in World.
+class Game: public WorldListener {
+    GLuint gProgram_;
+    GLuint gMeteorProgram_;
+    GLuint gParticleProgram_;
+    GLuint gUpscaleProgram_;
+    GLuint gaPositionHandle_;
+    GLuint gaColorHandle_;
+    GLuint guVeiwProjHandle_;
+
+    ndk_helper::Mat4 mProj_;
+    // Projection of outline batch positions, mProj_ scaled by the batch range
+    ndk_helper::Mat4 mOutlineProj_;
+    int width_;
+    int height_;
+    // Outlines fade out over a pixel wide fringe, blended
+    bool antialias_;
+
+    MeteorRenderMode meteorRenderMode_;
+    MeteorBatch* meteorBatch_;
+    OutlineBatch* outlineBatch_;
+    ParticleBatch* particleBatch_;
+    Hud* hud_;
+    // Scene resolution, full and straight into the surface without a scaler
+    ResolutionScaler* scaler_;
+    RenderTarget* target_;
+    GpuTimer* gpuTimer_;
+    World* world_;
+    // Tap stamps of the bullets drawn for the first time this frame
+    std::vector<int64_t> shownTaps_;
+
+public:
+    Game(int w, int h, bool antialias = true);
+    ~Game();
+    void work(double dt, int64_t frameTime);
+    void tap(float x, float y) { world_->tap(x, y); }
+    InputQueue& getInput() { return world_->getInput(); }
+    const std::vector<int64_t>& getShownTaps() { return shownTaps_; }
+    bool isOver() { return world_->isOver(); }
+    int getScore() { return world_->getScore(); }
+    void setMeteorRenderMode(MeteorRenderMode mode);
+    // The scaler outlives the game and keeps adapting across games, NULL
+    // draws at full resolution. The HUD is always drawn at full resolution.
+    void setResolutionScaler(ResolutionScaler* scaler);
+    void trimMemory() { world_->trimMemory(); }
+    World& getWorld() { return *world_; }
+    MemoryBudget& getMemoryBudget() { return world_->getMemoryBudget(); }
+    const MemoryStats& getMemoryStats() { return world_->getMemoryStats(); }
+
+    void onMeteorAdded(Meteor* meteor);
+    void onNodeRemoved(Node* node);
+};
+
+#endif
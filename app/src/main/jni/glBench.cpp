@@ -0,0 +1,250 @@
+// Headless GL benchmark. Plays autopilot games and draws them offscreen
+// through the outline batch, HUD, render target and resolution scaler of
+// the game, on any EGL with GLES2 pbuffers. On a Linux host that is Mesa,
+// llvmpipe without a GPU, so dynamic resolution can be watched reacting to
+// real GPU times without a device.
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util.h"
+#include "glUtil.h"
+#include "world.h"
+#include "autopilot.h"
+#include "outlineBatch.h"
+#include "hud.h"
+#include "renderTarget.h"
+#include "gpuTimer.h"
+#include "resolutionScaler.h"
+
+struct GlContext {
+    EGLDisplay display;
+    EGLSurface surface;
+    EGLContext context;
+};
+
+// Prefers Mesa's surfaceless platform, which needs no window system
+static EGLDisplay openDisplay() {
+    const char* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)
+        eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (extensions != NULL && strstr(extensions, "EGL_MESA_platform_surfaceless") != NULL &&
+        getPlatformDisplay != NULL) {
+        EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY,
+            NULL);
+        if (display != EGL_NO_DISPLAY) { return display; }
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+static bool createContext(int w, int h, GlContext& gl) {
+    gl.display = openDisplay();
+    EGLint major, minor;
+    if (gl.display == EGL_NO_DISPLAY || !eglInitialize(gl.display, &major, &minor)) {
+        LOGE("Could not initialize EGL (0x%x)", eglGetError());
+        return false;
+    }
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configs = 0;
+    if (!eglChooseConfig(gl.display, configAttribs, &config, 1, &configs) || configs == 0) {
+        LOGE("No EGL config with GLES2 pbuffers");
+        return false;
+    }
+
+    const EGLint surfaceAttribs[] = { EGL_WIDTH, w, EGL_HEIGHT, h, EGL_NONE };
+    gl.surface = eglCreatePbufferSurface(gl.display, config, surfaceAttribs);
+    eglBindAPI(EGL_OPENGL_ES_API);
+    const EGLint contextAttribs[] = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
+    gl.context = eglCreateContext(gl.display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (gl.surface == EGL_NO_SURFACE || gl.context == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(gl.display, gl.surface, gl.surface, gl.context)) {
+        LOGE("Could not create a %d x %d pbuffer context (0x%x)", w, h, eglGetError());
+        return false;
+    }
+
+    LOGI("EGL %d.%d, %s, %s", major, minor, glGetString(GL_RENDERER), glGetString(GL_VERSION));
+    return true;
+}
+
+static void destroyContext(GlContext& gl) {
+    eglMakeCurrent(gl.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(gl.display, gl.context);
+    eglDestroySurface(gl.display, gl.surface);
+    eglTerminate(gl.display);
+}
+
+// Strokes meteors once as they spawn, as the game does
+class OutlineCache: public WorldListener {
+    OutlineBatch* outlines_;
+
+public:
+    OutlineCache(OutlineBatch* outlines) : outlines_(outlines) {};
+    void onMeteorAdded(Meteor* meteor) { meteor->setOutlineSlot(outlines_->cache(meteor)); }
+    void onNodeRemoved(Node* node) {
+        if (node->getType() == METEOR || node->getType() == SMALL_METEOR) {
+            outlines_->forget(((Meteor*) node)->getOutlineSlot());
+        }
+    }
+};
+
+int main(int argc, char** argv) {
+    int width = 1080;
+    int height = 2160;
+    int frames = 1200;
+    int fps = 60;
+    double budget = 0.0;
+    float minScale = 0.5f;
+    unsigned seed = 1;
+    // The scene is drawn this many times, a stand in for heavier scenes
+    int overdraw = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+            width = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--height") == 0 && i + 1 < argc) {
+            height = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            fps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            budget = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--min-scale") == 0 && i + 1 < argc) {
+            minScale = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--overdraw") == 0 && i + 1 < argc) {
+            overdraw = atoi(argv[++i]);
+        } else {
+            LOGE("Usage: %s [--width W] [--height H] [--frames N] [--fps N] [--budget MS]\n"
+                "       %*s [--min-scale S] [--seed N] [--overdraw N]",
+                argv[0], (int) strlen(argv[0]), "");
+            return 2;
+        }
+    }
+
+    GlContext gl;
+    if (!createContext(width, height, gl)) { return 1; }
+
+    GLuint program = createProgram(gVertexShader, gFragmentShader);
+    GLuint upscaleProgram = createProgram(gUpscaleVertexShader, gUpscaleFragmentShader);
+    if (!program || !upscaleProgram) {
+        LOGE("Could not create programs");
+        return 1;
+    }
+    GLuint hPos = glGetAttribLocation(program, "aPosition");
+    GLuint hCol = glGetAttribLocation(program, "aColor");
+    GLuint hVP = glGetUniformLocation(program, "uViewProj");
+
+    float pixel = 2.0f / height;
+    OutlineBatch* outlines = new OutlineBatch(pixel, pixel, (float) width / height);
+    OutlineCache cache(outlines);
+
+    // The game's projection, scaled up by the range of the outline batch
+    float aspect = (float) height / width;
+    float range = outlines->getRange();
+    float projection[16] = { aspect * range, 0.0f, 0.0f, 0.0f,
+                             0.0f, range, 0.0f, 0.0f,
+                             0.0f, 0.0f, 0.0f, 0.0f,
+                             0.0f, 0.0f, 0.0f, 1.0f };
+    Hud* hud = new Hud(width, height);
+    GpuTimer* timer = new GpuTimer();
+    ResolutionScaler scaler;
+    scaler.setLimits(minScale, 1.0f);
+    scaler.setTargetFps(fps);
+    if (budget > 0.0) { scaler.setBudget(budget); }
+    RenderTarget* target = new RenderTarget(upscaleProgram, width, height, scaler.getMaxScale());
+    if (!target->isComplete()) { return 1; }
+
+    World* world = new World((float) width / height, seed);
+    world->setListener(&cache);
+    Autopilot pilot;
+    int games = 1;
+    double dt = 1.0 / (fps > 0 ? fps : 60);
+    int64_t frameNanos = (int64_t) (dt * 1e9);
+    int timed = 0;
+
+    int64_t start = monotonicNanos();
+    for (int frame = 1; frame <= frames; ++frame) {
+        int64_t frameTime = frame * frameNanos;
+        pilot.act(*world, frameTime);
+        world->step(dt, frameTime);
+        if (world->isOver()) {
+            delete world;
+            world = new World((float) width / height, seed + games);
+            world->setListener(&cache);
+            pilot.reset();
+            games++;
+        }
+
+        double gpuTime;
+        float drawnScale;
+        while (timer->poll(gpuTime, drawnScale)) {
+            timed++;
+            if (scaler.addFrame(gpuTime, drawnScale)) {
+                LOGI("Frame %d: %.2f ms at scale %.2f, now %.2f", frame, gpuTime, drawnScale,
+                    scaler.getScale());
+            }
+        }
+        float scale = scaler.getScale();
+        timer->begin(scale);
+        target->bind(scale);
+
+        glClearColor(0.2353f, 0.2471f, 0.2549f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glUseProgram(program);
+        glUniformMatrix4fv(hVP, 1, GL_FALSE, projection);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        outlines->clear();
+        const std::vector<Node*>& scene = world->getScene();
+        for (size_t i = 0; i < scene.size(); ++i) { outlines->add(scene[i]); }
+        for (int pass = 0; pass < overdraw; ++pass) { outlines->draw(hPos, hCol); }
+        glDisable(GL_BLEND);
+
+        target->present();
+        glUseProgram(program);
+        hud->setScore(world->getScore());
+        hud->draw(hPos, hCol, hVP);
+        timer->end();
+        eglSwapBuffers(gl.display, gl.surface);
+    }
+    glFinish();
+    int64_t elapsed = monotonicNanos() - start;
+
+    // The corner is background, upscaled or not
+    GLubyte corner[4];
+    glReadPixels(0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, corner);
+    checkGlError("glReadPixels");
+
+    double seconds = elapsed / 1e9;
+    LOGI("Frames: %d in %.3f s, %.1f frames/s, %d games, %d timed on the GPU", frames, seconds,
+        frames / seconds, games, timed);
+    scaler.log("Resolution");
+    LOGI("Surface corner: %d %d %d", corner[0], corner[1], corner[2]);
+    bool scaled = !timer->isAvailable() || timed > 0;
+    bool presented = abs(corner[0] - 60) <= 1 && abs(corner[1] - 63) <= 1 &&
+        abs(corner[2] - 65) <= 1;
+
+    delete world;
+    delete target;
+    delete timer;
+    delete hud;
+    delete outlines;
+    glDeleteProgram(program);
+    glDeleteProgram(upscaleProgram);
+    destroyContext(gl);
+
+    return scaled && presented ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+#include "glUtil.h"
+
+#include <stdlib.h>
+
+#include "util.h"
+
+const char gVertexShader[] =
+    "uniform highp mat4 uViewProj;\n"
+    "attribute vec2 aPosition;\n"
+    "attribute vec4 aColor;\n"
+    "varying vec4 vColor;\n"
+    "void main() {\n"
+    "  highp vec4 p = vec4(aPosition, 0, 1);\n"
+    "  vColor = aColor;\n"
+    "  gl_Position = uViewProj * p;\n"
+    "}\n";
+
+const char gFragmentShader[] =
+    "precision mediump float;\n"
+    "varying vec4 vColor;\n"
+    "void main() {\n"
+    "  gl_FragColor = vColor;\n"
+    "}\n";
+
+void printGLString(const char *name, GLenum s) {
+    const char *v = (const char *) glGetString(s);
+    LOGI("GL %s = %s\n", name, v);
+}
+
+void checkGlError(const char* op) {
+    for (GLint error = glGetError(); error; error = glGetError()) {
+        LOGI("after %s() glError (0x%x)\n", op, error);
+    }
+}
+
+GLuint loadShader(GLenum shaderType, const char* pSource) {
+    GLuint shader = glCreateShader(shaderType);
+    if (!shader) { return shader; }
+
+    glShaderSource(shader, 1, &pSource, NULL);
+    glCompileShader(shader);
+    GLint compiled = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (compiled) { return shader; }
+
+    GLint infoLen = 0;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLen);
+    if (!infoLen) { return shader; }
+
+    char* buf = (char*) malloc(infoLen);
+    if (buf) {
+        glGetShaderInfoLog(shader, infoLen, NULL, buf);
+        LOGE("Could not compile shader %d:\n%s\n", shaderType, buf);
+        free(buf);
+    }
+    glDeleteShader(shader);
+    shader = 0;
+
+    return shader;
+}
+
+GLuint createProgram(const char* pVertexSource, const char* pFragmentSource) {
+    GLuint vertexShader = loadShader(GL_VERTEX_SHADER, pVertexSource);
+    if (!vertexShader) { return 0; }
+
+    GLuint pixelShader = loadShader(GL_FRAGMENT_SHADER, pFragmentSource);
+    if (!pixelShader) { return 0; }
+
+    GLuint program = glCreateProgram();
+    if (!program) { return program; }
+
+    glAttachShader(program, vertexShader);
+    checkGlError("glAttachShader");
+    glAttachShader(program, pixelShader);
+    checkGlError("glAttachShader");
+    glLinkProgram(program);
+    GLint linkStatus = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+
+    if (linkStatus == GL_TRUE) { return program; }
+
+    GLint bufLength = 0;
+    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &bufLength);
+
+    if (bufLength) {
+        char* buf = (char*) malloc(bufLength);
+        if (buf) {
+            glGetProgramInfoLog(program, bufLength, NULL, buf);
+            LOGE("Could not link program:\n%s\n", buf);
+            free(buf);
+        }
+    }
+    glDeleteProgram(program);
+    program = 0;
+
+    return program;
+}
@@ -0,0 +1,17 @@
+#ifndef GL_UTIL_H
+#define GL_UTIL_H
+
+#include <GLES2/gl2.h>
+
+// Scene program, positions with a color each under one transform
+extern const char gVertexShader[];
+extern const char gFragmentShader[];
+
+void printGLString(const char *name, GLenum s);
+void checkGlError(const char* op);
+
+// Compiles and links a program, returns 0 and logs the reason on failure
+GLuint loadShader(GLenum shaderType, const char* pSource);
+GLuint createProgram(const char* pVertexSource, const char* pFragmentSource);
+
+#endif
@@ -0,0 +1,87 @@
+#include "gpuTimer.h"
+
+#include <EGL/egl.h>
+#include <string.h>
+
+#include "util.h"
+#include "glUtil.h"
+
+GpuTimer::GpuTimer()
+    : available_(false), first_(0), pending_(0), running_(false), genQueries_(NULL),
+    deleteQueries_(NULL), beginQuery_(NULL), endQuery_(NULL), getQueryObjectuiv_(NULL),
+    getQueryObjectui64v_(NULL)
+{
+    const char* extensions = (const char*) glGetString(GL_EXTENSIONS);
+    if (extensions == NULL || strstr(extensions, "GL_EXT_disjoint_timer_query") == NULL) {
+        LOGI("No GL_EXT_disjoint_timer_query, frames are not timed on the GPU");
+        return;
+    }
+
+    genQueries_ = (PFNGLGENQUERIESEXTPROC) eglGetProcAddress("glGenQueriesEXT");
+    deleteQueries_ = (PFNGLDELETEQUERIESEXTPROC) eglGetProcAddress("glDeleteQueriesEXT");
+    beginQuery_ = (PFNGLBEGINQUERYEXTPROC) eglGetProcAddress("glBeginQueryEXT");
+    endQuery_ = (PFNGLENDQUERYEXTPROC) eglGetProcAddress("glEndQueryEXT");
+    getQueryObjectuiv_ = (PFNGLGETQUERYOBJECTUIVEXTPROC)
+        eglGetProcAddress("glGetQueryObjectuivEXT");
+    getQueryObjectui64v_ = (PFNGLGETQUERYOBJECTUI64VEXTPROC)
+        eglGetProcAddress("glGetQueryObjectui64vEXT");
+    if (!genQueries_ || !deleteQueries_ || !beginQuery_ || !endQuery_ || !getQueryObjectuiv_ ||
+        !getQueryObjectui64v_) {
+        LOGE("GL_EXT_disjoint_timer_query is missing entry points");
+        return;
+    }
+
+    genQueries_(GPU_TIMER_QUERIES, queries_);
+    checkGlError("glGenQueriesEXT");
+    // Reading the flag clears it, so old disjoint events don't drop the first frames
+    GLint disjoint = 0;
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+    available_ = true;
+}
+
+void GpuTimer::begin(float tag) {
+    if (!available_ || running_ || pending_ == GPU_TIMER_QUERIES) { return; }
+
+    int index = (first_ + pending_) % GPU_TIMER_QUERIES;
+    tags_[index] = tag;
+    beginQuery_(GL_TIME_ELAPSED_EXT, queries_[index]);
+    running_ = true;
+}
+
+void GpuTimer::end() {
+    if (!running_) { return; }
+
+    endQuery_(GL_TIME_ELAPSED_EXT);
+    running_ = false;
+    pending_++;
+}
+
+bool GpuTimer::poll(double& milliseconds, float& tag) {
+    while (pending_ > 0) {
+        GLuint query = queries_[first_];
+        GLuint ready = 0;
+        getQueryObjectuiv_(query, GL_QUERY_RESULT_AVAILABLE_EXT, &ready);
+        if (!ready) { return false; }
+
+        GLuint64 nanos = 0;
+        getQueryObjectui64v_(query, GL_QUERY_RESULT_EXT, &nanos);
+        tag = tags_[first_];
+        first_ = (first_ + 1) % GPU_TIMER_QUERIES;
+        pending_--;
+
+        GLint disjoint = 0;
+        glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+        if (!disjoint) {
+            milliseconds = nanos / 1e6;
+            return true;
+        }
+    }
+    return false;
+}
+
+GpuTimer::~GpuTimer() {
+    if (available_) {
+        if (running_) { endQuery_(GL_TIME_ELAPSED_EXT); }
+        deleteQueries_(GPU_TIMER_QUERIES, queries_);
+    }
+}
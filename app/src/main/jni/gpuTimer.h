@@ -0,0 +1,42 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+// Frames in flight the timer keeps queries for
+#define GPU_TIMER_QUERIES 4
+
+// Times frames on the GPU with GL_EXT_disjoint_timer_query. Results are
+// read a few frames later, once the GPU got to them, so timing never
+// stalls the pipeline. Without the extension nothing is ever timed.
+class GpuTimer {
+    bool available_;
+    GLuint queries_[GPU_TIMER_QUERIES];
+    // Tag of every query, e.g. the scale its frame was drawn at
+    float tags_[GPU_TIMER_QUERIES];
+    // Queries begun but not read yet, oldest first
+    int first_;
+    int pending_;
+    bool running_;
+
+    PFNGLGENQUERIESEXTPROC genQueries_;
+    PFNGLDELETEQUERIESEXTPROC deleteQueries_;
+    PFNGLBEGINQUERYEXTPROC beginQuery_;
+    PFNGLENDQUERYEXTPROC endQuery_;
+    PFNGLGETQUERYOBJECTUIVEXTPROC getQueryObjectuiv_;
+    PFNGLGETQUERYOBJECTUI64VEXTPROC getQueryObjectui64v_;
+
+public:
+    GpuTimer();
+    ~GpuTimer();
+    bool isAvailable() { return available_; }
+    // Times the GL commands until end. Skipped while every query is in flight.
+    void begin(float tag);
+    void end();
+    // Takes the oldest frame the GPU finished, false if there is none.
+    // Frames the GPU was disjoint in, e.g. throttled, are dropped.
+    bool poll(double& milliseconds, float& tag);
+};
+
+#endif
@@ -0,0 +1,199 @@
+#include "hud.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "glUtil.h"
+
+// Stroke font. Every glyph is a list of "x0y0x1y1" segments, y goes up.
+static const char* glyphStrokes(char c) {
+    switch (c) {
+    case '0': return "0040 4046 4606 0600 0046";
+    case '1': return "2026 2615 1030";
+    case '2': return "0646 4643 4303 0300 0040";
+    case '3': return "0646 4640 4000 1343";
+    case '4': return "0603 0343 4640";
+    case '5': return "4606 0603 0343 4340 4000";
+    case '6': return "4606 0600 0040 4043 4303";
+    case '7': return "0646 4620";
+    case '8': return "0040 4046 4606 0600 0343";
+    case '9': return "4303 0306 0646 4640 4000";
+    case 'A': return "0004 0426 2644 4440 0343";
+    case 'B': return "0006 0636 3645 4544 4433 3303 3342 4241 4130 3000";
+    case 'C': return "4606 0600 0040";
+    case 'D': return "0006 0636 3645 4541 4130 3000";
+    case 'E': return "4606 0600 0040 0333";
+    case 'F': return "4606 0600 0333";
+    case 'G': return "4606 0600 0040 4043 4323";
+    case 'H': return "0006 4640 0343";
+    case 'I': return "0646 2620 0040";
+    case 'J': return "0646 3631 3120 2010 1001";
+    case 'K': return "0006 0346 0340";
+    case 'L': return "0600 0040";
+    case 'M': return "0006 0623 2346 4640";
+    case 'N': return "0006 0640 4046";
+    case 'O': return "0040 4046 4606 0600";
+    case 'P': return "0006 0646 4643 4303";
+    case 'Q': return "0040 4046 4606 0600 2240";
+    case 'R': return "0006 0646 4643 4303 2340";
+    case 'S': return "4606 0603 0343 4340 4000";
+    case 'T': return "0646 2620";
+    case 'U': return "0600 0040 4046";
+    case 'V': return "0620 2046";
+    case 'W': return "0600 0023 2340 4046";
+    case 'X': return "0046 0640";
+    case 'Y': return "0623 2346 2320";
+    case 'Z': return "0646 4600 0040";
+    case ':': return "2122 2425";
+    case '!': return "2623 2120";
+    case '.': return "2021";
+    case '-': return "1333";
+    default: return "";
+    }
+}
+
+HudText::HudText(HudAlign align)
+    : vertexCount_(0), align_(align)
+{
+    text_[0] = '\0';
+    for (int i = 0; i < HUD_MAX_SEGMENTS * HUD_SEGMENT_VERTICES * COLOR_COMPONENTS; ++i) {
+        colors_[i] = COLOR_ONE;
+    }
+}
+
+void HudText::set(const char* text, float unitX, float unitY, float pixelX, float pixelY) {
+    if (strncmp(text, text_, HUD_MAX_TEXT - 1) == 0) { return; }
+
+    snprintf(text_, sizeof(text_), "%s", text);
+    build(unitX, unitY, pixelX, pixelY);
+}
+
+// Widens the segment to HUD_STROKE pixels, measured in pixels so the
+// stroke is as thick across as along whatever the aspect
+void HudText::addSegment(float x0, float y0, float x1, float y1, float pixelX, float pixelY) {
+    float dx = (x1 - x0) / pixelX;
+    float dy = (y1 - y0) / pixelY;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length < 1e-6f) {
+        dx = 1.0f;
+        dy = 0.0f;
+    } else {
+        dx /= length;
+        dy /= length;
+    }
+
+    // Half the stroke along the segment for the caps and across it for the width
+    float half = HUD_STROKE / 2;
+    float ax = dx * half * pixelX, ay = dy * half * pixelY;
+    float nx = -dy * half * pixelX, ny = dx * half * pixelY;
+    float corners[4][2] = {
+        { x0 - ax + nx, y0 - ay + ny },
+        { x0 - ax - nx, y0 - ay - ny },
+        { x1 + ax + nx, y1 + ay + ny },
+        { x1 + ax - nx, y1 + ay - ny }
+    };
+    static const int quad[HUD_SEGMENT_VERTICES] = { 0, 1, 2, 2, 1, 3 };
+
+    GLshort* v = vertices_ + vertexCount_ * DIMENTIONS;
+    for (int i = 0; i < HUD_SEGMENT_VERTICES; ++i) {
+        v[i * 2] = quantizePosition(corners[quad[i]][0]);
+        v[i * 2 + 1] = quantizePosition(corners[quad[i]][1]);
+    }
+    vertexCount_ += HUD_SEGMENT_VERTICES;
+}
+
+void HudText::build(float unitX, float unitY, float pixelX, float pixelY) {
+    vertexCount_ = 0;
+
+    int lines = 1;
+    for (const char* c = text_; *c; ++c) {
+        if (*c == '\n') { lines++; }
+    }
+
+    float margin = GLYPH_ADVANCE - 4;
+    float top = align_ == HUD_ALIGN_CENTER ?
+        (lines * GLYPH_LINE - (GLYPH_LINE - 6)) * unitY / 2 : 1.0f - margin * unitY;
+
+    const char* line = text_;
+    for (int l = 0; l < lines; ++l) {
+        int length = strcspn(line, "\n");
+        float width = length * GLYPH_ADVANCE - margin;
+        float left = align_ == HUD_ALIGN_CENTER ?
+            -width * unitX / 2 : 1.0f - (width + margin) * unitX;
+        float bottom = top - 6 * unitY;
+
+        for (int i = 0; i < length; ++i) {
+            char c = line[i];
+            if (c >= 'a' && c <= 'z') { c += 'A' - 'a'; }
+
+            const char* stroke = glyphStrokes(c);
+            float x = left + i * GLYPH_ADVANCE * unitX;
+            for (; stroke[0] && stroke[1] && stroke[2] && stroke[3]; stroke += 4) {
+                if (vertexCount_ + HUD_SEGMENT_VERTICES > HUD_MAX_SEGMENTS * HUD_SEGMENT_VERTICES) {
+                    return;
+                }
+
+                addSegment(x + (stroke[0] - '0') * unitX, bottom + (stroke[1] - '0') * unitY,
+                    x + (stroke[2] - '0') * unitX, bottom + (stroke[3] - '0') * unitY,
+                    pixelX, pixelY);
+
+                if (stroke[4] == ' ') { stroke++; }
+            }
+        }
+
+        top -= GLYPH_LINE * unitY;
+        line += length + (line[length] == '\n' ? 1 : 0);
+    }
+}
+
+void HudText::draw(GLuint hPos, GLuint hCol) {
+    if (vertexCount_ == 0) { return; }
+
+    glVertexAttribPointer(hPos, DIMENTIONS, GL_SHORT, GL_TRUE, 0, vertices_);
+    glEnableVertexAttribArray(hPos);
+    glVertexAttribPointer(hCol, COLOR_COMPONENTS, GL_UNSIGNED_BYTE, GL_TRUE, 0, colors_);
+    glEnableVertexAttribArray(hCol);
+    checkGlError("HudText attributes");
+
+    glDrawArrays(GL_TRIANGLES, 0, vertexCount_);
+    checkGlError("glDrawArrays");
+}
+
+Hud::Hud(int w, int h)
+    : score_(HUD_ALIGN_TOP_RIGHT), message_(HUD_ALIGN_CENTER), shownScore_(-1)
+{
+    // Glyphs are about a thirtieth of the screen height tall
+    float pixels = h / 180.0f;
+    unitX_ = 2.0f * pixels / w;
+    unitY_ = 2.0f * pixels / h;
+    pixelX_ = 2.0f / w;
+    pixelY_ = 2.0f / h;
+
+    memset(identity_, 0, sizeof(identity_));
+    identity_[0] = identity_[5] = identity_[10] = identity_[15] = 1.0f;
+
+    setScore(0);
+}
+
+void Hud::setScore(int score) {
+    if (score == shownScore_) { return; }
+    shownScore_ = score;
+
+    char text[HUD_MAX_TEXT];
+    snprintf(text, sizeof(text), "SCORE %d", score);
+    score_.set(text, unitX_, unitY_, pixelX_, pixelY_);
+}
+
+void Hud::setMessage(const char* text) {
+    message_.set(text, unitX_, unitY_, pixelX_, pixelY_);
+}
+
+// Draws with the scene program, text is already in clip space
+void Hud::draw(GLuint hPos, GLuint hCol, GLuint hVP) {
+    glUniformMatrix4fv(hVP, 1, GL_FALSE, identity_);
+    checkGlError("glUniformMatrix4fv");
+
+    score_.draw(hPos, hCol);
+    message_.draw(hPos, hCol);
+}
@@ -0,0 +1,64 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <GLES2/gl2.h>
+
+#include "node.h"
+
+// Glyphs live on a 4 x 6 grid, text advances 6 units per char and 10 per line
+#define GLYPH_ADVANCE 6
+#define GLYPH_LINE 10
+#define HUD_MAX_TEXT 64
+// Enough for the busiest glyphs on every char
+#define HUD_MAX_SEGMENTS (HUD_MAX_TEXT * 10)
+// Every segment is a quad of two triangles
+#define HUD_SEGMENT_VERTICES 6
+// Stroke width in pixels
+#define HUD_STROKE 2.0f
+
+enum HudAlign {
+    HUD_ALIGN_CENTER,
+    HUD_ALIGN_TOP_RIGHT
+};
+
+// Text drawn as GL_TRIANGLES in clip space, a quad per stroke segment with
+// square caps. The geometry is only rebuilt when the text changes.
+class HudText {
+    char text_[HUD_MAX_TEXT];
+    // Clip space positions in the compact format, see vertexFormat.h
+    GLshort vertices_[HUD_MAX_SEGMENTS * HUD_SEGMENT_VERTICES * DIMENTIONS];
+    GLubyte colors_[HUD_MAX_SEGMENTS * HUD_SEGMENT_VERTICES * COLOR_COMPONENTS];
+    int vertexCount_;
+    HudAlign align_;
+
+    void build(float unitX, float unitY, float pixelX, float pixelY);
+    void addSegment(float x0, float y0, float x1, float y1, float pixelX, float pixelY);
+
+public:
+    HudText(HudAlign align);
+    // Units are the glyph grid unit and the pixel in clip space
+    void set(const char* text, float unitX, float unitY, float pixelX, float pixelY);
+    void draw(GLuint hPos, GLuint hCol);
+};
+
+// Score in the top right corner and a message in the middle of the screen
+class Hud {
+    HudText score_;
+    HudText message_;
+    int shownScore_;
+    // Size of one glyph grid unit in clip space
+    float unitX_;
+    float unitY_;
+    // Size of one pixel in clip space
+    float pixelX_;
+    float pixelY_;
+    float identity_[16];
+
+public:
+    Hud(int w, int h);
+    void setScore(int score);
+    void setMessage(const char* text);
+    void draw(GLuint hPos, GLuint hCol, GLuint hVP);
+};
+
+#endif
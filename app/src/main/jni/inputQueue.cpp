@@ -0,0 +1,27 @@
+#include "inputQueue.h"
+
+bool InputQueue::push(float x, float y, int64_t time) {
+    unsigned tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+    unsigned head = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+    if (tail - head == INPUT_QUEUE_SIZE) {
+        dropped_++;
+        return false;
+    }
+
+    TapEvent& event = events_[tail & (INPUT_QUEUE_SIZE - 1)];
+    event.x = x;
+    event.y = y;
+    event.time = time;
+    __atomic_store_n(&tail_, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool InputQueue::pop(TapEvent& event) {
+    unsigned head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+    unsigned tail = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+    if (head == tail) { return false; }
+
+    event = events_[head & (INPUT_QUEUE_SIZE - 1)];
+    __atomic_store_n(&head_, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
@@ -0,0 +1,31 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <stdint.h>
+
+// Must be a power of two
+#define INPUT_QUEUE_SIZE 64
+
+struct TapEvent {
+    float x;
+    float y;
+    // Event time in nanoseconds of CLOCK_MONOTONIC, also used as the tap tag
+    int64_t time;
+};
+
+// Lock-free single producer, single consumer ring of taps.
+// The input handler pushes, the simulation pops at the start of a step.
+class InputQueue {
+    TapEvent events_[INPUT_QUEUE_SIZE];
+    unsigned head_;
+    unsigned tail_;
+    unsigned dropped_;
+
+public:
+    InputQueue() : head_(0), tail_(0), dropped_(0) {};
+    bool push(float x, float y, int64_t time);
+    bool pop(TapEvent& event);
+    unsigned getDropped() { return dropped_; };
+};
+
+#endif
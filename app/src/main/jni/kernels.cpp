@@ -0,0 +1,87 @@
+#include "kernels.h"
+
+#include <stddef.h>
+
+#include "util.h"
+
+#ifdef __ANDROID__
+#include <cpu-features.h>
+#endif
+
+static void boundsScalar(const int16_t* vertices, int count, float sx, float sy, float* box) {
+    if (count == 0) {
+        box[0] = box[1] = box[2] = box[3] = 0.0f;
+        return;
+    }
+
+    int xmin = vertices[0], xmax = vertices[0];
+    int ymin = vertices[1], ymax = vertices[1];
+    for (int i = 1; i < count; ++i) {
+        int x = vertices[i * 2];
+        int y = vertices[i * 2 + 1];
+
+        if (x < xmin) { xmin = x; }
+        if (x > xmax) { xmax = x; }
+        if (y < ymin) { ymin = y; }
+        if (y > ymax) { ymax = y; }
+    }
+
+    scaleBox(xmin, xmax, ymin, ymax, sx, sy, box);
+}
+
+bool isInsideScalar(const int16_t* vertices, int count, float sx, float sy,
+    float ox, float oy, float x, float y) {
+    // Moving the point instead of the polygon saves the per vertex work
+    toQuantized(sx, sy, ox, oy, x, y);
+
+    bool result = false;
+    for (int i = 0, j = count - 1; i < count; j = i++) {
+        float curX = vertices[i * 2], curY = vertices[i * 2 + 1];
+        float prevX = vertices[j * 2], prevY = vertices[j * 2 + 1];
+
+        if ((curY > y) != (prevY > y) &&
+            (x < (prevX - curX) * (y - curY) / (prevY - curY) + curX)) {
+            result = !result;
+        }
+    }
+
+    return result;
+}
+
+const GeometryKernels scalarKernels = {
+    "scalar", boundsScalar, isInsideScalar
+};
+
+GeometryKernels gKernels = scalarKernels;
+
+#ifndef HAVE_NEON_KERNELS
+const GeometryKernels* neonKernels = NULL;
+#endif
+#ifndef HAVE_X86_KERNELS
+const GeometryKernels* sse4Kernels = NULL;
+const GeometryKernels* avx2Kernels = NULL;
+#endif
+
+void initKernels() {
+    gKernels = scalarKernels;
+
+#if defined(__arm__) || defined(__aarch64__)
+    bool neon = true;
+#ifdef __ANDROID__
+    // arm64 always has it, armeabi-v7a devices may not
+    neon = android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM64 ||
+        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0;
+#endif
+    if (neon && neonKernels != NULL) { gKernels = *neonKernels; }
+#elif defined(__i386__) || defined(__x86_64__)
+    // cpuid tells about SSE4.1 and AVX2 on both Android and host builds
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && avx2Kernels != NULL) {
+        gKernels = *avx2Kernels;
+    } else if (__builtin_cpu_supports("sse4.1") && sse4Kernels != NULL) {
+        gKernels = *sse4Kernels;
+    }
+#endif
+
+    LOGI("Geometry kernels: %s", gKernels.name);
+}
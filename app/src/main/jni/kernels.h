@@ -0,0 +1,52 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <stdint.h>
+
+#include "vertexFormat.h"
+
+// Geometry and collision kernels working on interleaved x, y quantized
+// vertices, dequantized as they are loaded. The scales sx and sy are positive.
+// Every variant gives the same results as the scalar reference.
+struct GeometryKernels {
+    const char* name;
+    // Writes xmin, xmax, ymin, ymax of the vertices scaled by (sx, sy) to box
+    void (*bounds)(const int16_t* vertices, int count, float sx, float sy, float* box);
+    // Even-odd test of the point (x, y) against the polygon scaled by (sx, sy)
+    // and moved by (ox, oy)
+    bool (*isInside)(const int16_t* vertices, int count, float sx, float sy,
+        float ox, float oy, float x, float y);
+};
+
+// Bounds are found on the quantized values, so every variant scales them the same way
+inline void scaleBox(int xmin, int xmax, int ymin, int ymax, float sx, float sy, float* box) {
+    box[0] = (float) xmin / POSITION_ONE * sx;
+    box[1] = (float) xmax / POSITION_ONE * sx;
+    box[2] = (float) ymin / POSITION_ONE * sy;
+    box[3] = (float) ymax / POSITION_ONE * sy;
+}
+
+// The point moved into the quantized space of the polygon, where it is tested
+inline void toQuantized(float sx, float sy, float ox, float oy, float& x, float& y) {
+    x = (x - ox) / sx * POSITION_ONE;
+    y = (y - oy) / sy * POSITION_ONE;
+}
+
+// The even-odd test of every variant. Polygons have a handful of vertices,
+// so gathering their edges into lanes costs more than the vector test saves.
+bool isInsideScalar(const int16_t* vertices, int count, float sx, float sy,
+    float ox, float oy, float x, float y);
+
+// Kernels picked by initKernels, scalar until then
+extern GeometryKernels gKernels;
+
+extern const GeometryKernels scalarKernels;
+// Variants compiled in for this ABI, NULL when not built
+extern const GeometryKernels* neonKernels;
+extern const GeometryKernels* sse4Kernels;
+extern const GeometryKernels* avx2Kernels;
+
+// Selects the fastest variants the CPU supports and logs the choice
+void initKernels();
+
+#endif
@@ -0,0 +1,50 @@
+#include "kernels.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(__aarch64__)
+
+#include <arm_neon.h>
+#include <string.h>
+
+// One x, y pair of shorts repeated over the register
+static inline int16x4_t loadPairNeon(const int16_t* vertex) {
+    int32_t pair;
+    memcpy(&pair, vertex, sizeof(pair));
+    return vreinterpret_s16_s32(vdup_n_s32(pair));
+}
+
+static void boundsNeon(const int16_t* vertices, int count, float sx, float sy, float* box) {
+    if (count == 0) {
+        box[0] = box[1] = box[2] = box[3] = 0.0f;
+        return;
+    }
+
+    int16x4_t first = loadPairNeon(vertices);
+    int16x8_t low = vcombine_s16(first, first);
+    int16x8_t high = low;
+    int i = 1;
+    for (; i + 4 <= count; i += 4) {
+        int16x8_t pairs = vld1q_s16(vertices + i * 2);
+        low = vminq_s16(low, pairs);
+        high = vmaxq_s16(high, pairs);
+    }
+
+    int16x4_t low2 = vmin_s16(vget_low_s16(low), vget_high_s16(low));
+    int16x4_t high2 = vmax_s16(vget_low_s16(high), vget_high_s16(high));
+    for (; i < count; ++i) {
+        int16x4_t pair = loadPairNeon(vertices + i * 2);
+        low2 = vmin_s16(low2, pair);
+        high2 = vmax_s16(high2, pair);
+    }
+    // Fold the second pair onto the first
+    low2 = vmin_s16(low2, vext_s16(low2, low2, 2));
+    high2 = vmax_s16(high2, vext_s16(high2, high2, 2));
+
+    scaleBox(vget_lane_s16(low2, 0), vget_lane_s16(high2, 0),
+        vget_lane_s16(low2, 1), vget_lane_s16(high2, 1), sx, sy, box);
+}
+
+static const GeometryKernels neon = { "neon", boundsNeon, isInsideScalar };
+
+const GeometryKernels* neonKernels = &neon;
+
+#endif
@@ -0,0 +1,88 @@
+#include "kernels.h"
+
+#if defined(__i386__) || defined(__x86_64__)
+
+#include <immintrin.h>
+#include <string.h>
+
+// Both variants are compiled with function level target attributes, so this
+// file builds without -msse4.1 or -mavx2 and only runs where initKernels
+// found the instructions.
+
+#define SSE4 __attribute__((target("sse4.1")))
+#define AVX2 __attribute__((target("avx2")))
+
+// One x, y pair of shorts repeated over the register
+SSE4 static inline __m128i loadPairSse4(const int16_t* vertex) {
+    int32_t pair;
+    memcpy(&pair, vertex, sizeof(pair));
+    return _mm_set1_epi32(pair);
+}
+
+// Reduces the x, y pairs of low and high to the bounding box
+SSE4 static inline void storeBoxSse4(__m128i low, __m128i high, float sx, float sy, float* box) {
+    low = _mm_min_epi16(low, _mm_shuffle_epi32(low, _MM_SHUFFLE(1, 0, 3, 2)));
+    low = _mm_min_epi16(low, _mm_shuffle_epi32(low, _MM_SHUFFLE(2, 3, 0, 1)));
+    high = _mm_max_epi16(high, _mm_shuffle_epi32(high, _MM_SHUFFLE(1, 0, 3, 2)));
+    high = _mm_max_epi16(high, _mm_shuffle_epi32(high, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    scaleBox((int16_t) _mm_extract_epi16(low, 0), (int16_t) _mm_extract_epi16(high, 0),
+        (int16_t) _mm_extract_epi16(low, 1), (int16_t) _mm_extract_epi16(high, 1), sx, sy, box);
+}
+
+SSE4 static void boundsSse4(const int16_t* vertices, int count, float sx, float sy, float* box) {
+    if (count == 0) {
+        box[0] = box[1] = box[2] = box[3] = 0.0f;
+        return;
+    }
+
+    __m128i low = loadPairSse4(vertices);
+    __m128i high = low;
+    int i = 1;
+    for (; i + 4 <= count; i += 4) {
+        __m128i pairs = _mm_loadu_si128((const __m128i*) (vertices + i * 2));
+        low = _mm_min_epi16(low, pairs);
+        high = _mm_max_epi16(high, pairs);
+    }
+    for (; i < count; ++i) {
+        __m128i pair = loadPairSse4(vertices + i * 2);
+        low = _mm_min_epi16(low, pair);
+        high = _mm_max_epi16(high, pair);
+    }
+
+    storeBoxSse4(low, high, sx, sy, box);
+}
+
+AVX2 static void boundsAvx2(const int16_t* vertices, int count, float sx, float sy, float* box) {
+    if (count < 8) {
+        boundsSse4(vertices, count, sx, sy, box);
+        return;
+    }
+
+    __m256i low = _mm256_loadu_si256((const __m256i*) vertices);
+    __m256i high = low;
+    int i = 8;
+    for (; i + 8 <= count; i += 8) {
+        __m256i pairs = _mm256_loadu_si256((const __m256i*) (vertices + i * 2));
+        low = _mm256_min_epi16(low, pairs);
+        high = _mm256_max_epi16(high, pairs);
+    }
+
+    __m128i low4 = _mm_min_epi16(_mm256_castsi256_si128(low), _mm256_extracti128_si256(low, 1));
+    __m128i high4 = _mm_max_epi16(_mm256_castsi256_si128(high), _mm256_extracti128_si256(high, 1));
+    for (; i < count; ++i) {
+        __m128i pair = loadPairSse4(vertices + i * 2);
+        low4 = _mm_min_epi16(low4, pair);
+        high4 = _mm_max_epi16(high4, pair);
+    }
+
+    storeBoxSse4(low4, high4, sx, sy, box);
+}
+
+static const GeometryKernels sse4 = { "sse4.1", boundsSse4, isInsideScalar };
+static const GeometryKernels avx2 = { "avx2", boundsAvx2, isInsideScalar };
+
+const GeometryKernels* sse4Kernels = &sse4;
+const GeometryKernels* avx2Kernels = &avx2;
+
+#endif
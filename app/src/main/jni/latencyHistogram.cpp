@@ -0,0 +1,42 @@
+#include "latencyHistogram.h"
+
+#include <string.h>
+
+#include "util.h"
+
+void LatencyHistogram::reset() {
+    memset(buckets_, 0, sizeof(buckets_));
+    count_ = 0;
+    sum_ = 0;
+    max_ = 0;
+}
+
+void LatencyHistogram::add(int64_t latency) {
+    if (latency < 0) { latency = 0; }
+
+    int64_t bucket = latency / 1000000;
+    if (bucket >= LATENCY_BUCKETS) { bucket = LATENCY_BUCKETS - 1; }
+
+    buckets_[bucket]++;
+    count_++;
+    sum_ += latency;
+    if (latency > max_) { max_ = latency; }
+}
+
+int LatencyHistogram::getPercentile(float fraction) {
+    unsigned target = (unsigned) (fraction * count_);
+    unsigned seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; ++i) {
+        seen += buckets_[i];
+        if (seen > target) { return i + 1; }
+    }
+    return LATENCY_BUCKETS;
+}
+
+void LatencyHistogram::log(const char* name) {
+    if (count_ == 0) { return; }
+
+    LOGI("%s latency: %u samples, mean %.1f ms, p50 <%d ms, p90 <%d ms, p99 <%d ms, max %.1f ms",
+        name, count_, sum_ / 1e6 / count_, getPercentile(0.5f), getPercentile(0.9f),
+        getPercentile(0.99f), max_ / 1e6);
+}
@@ -0,0 +1,26 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+
+// One millisecond per bucket, the last one collects everything slower
+#define LATENCY_BUCKETS 101
+
+// Histogram of latencies given in nanoseconds
+class LatencyHistogram {
+    unsigned buckets_[LATENCY_BUCKETS];
+    unsigned count_;
+    int64_t sum_;
+    int64_t max_;
+
+public:
+    LatencyHistogram() { reset(); };
+    void reset();
+    void add(int64_t latency);
+    unsigned getCount() { return count_; };
+    // Upper bound of the bucket holding the given fraction of samples, in ms
+    int getPercentile(float fraction);
+    void log(const char* name);
+};
+
+#endif
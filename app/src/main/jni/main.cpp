@@ -7,16 +7,26 @@
 //--------------------------------------------------------------------------------
 #include <jni.h>
 #include <errno.h>
+#include <math.h>
+#include <stdlib.h>
 
 #include <android/log.h>
 #include <android_native_app_glue.h>
 #include <android/native_window_jni.h>
 #include <cpu-features.h>
 #include <NDKHelper.h>
+#include <sys/system_properties.h>
 #include <string>
 
-#include "util.cpp"
-#include "game.cpp"
+#include "util.h"
+#include "kernels.h"
+#include "game.h"
+#include "latencyHistogram.h"
+#include "autopilot.h"
+#include "trace.h"
+#include "allocTracker.h"
+#include "framePacer.h"
+#include "resolutionScaler.h"
 
 using namespace std;
 
@@ -24,6 +34,8 @@ using namespace std;
 //Preprocessor
 //-------------------------------------------------------------------------
 #define HELPER_CLASS_NAME "com/android/gunner/NDKHelper" //Class name of helper function
+// Longest a static screen goes without a frame, in seconds
+#define MAX_HOLD 1.0
 //-------------------------------------------------------------------------
 //Shared state for our app.
 //-------------------------------------------------------------------------
@@ -38,8 +50,21 @@ class Engine
     bool hasFocus_;
 
     ndk_helper::DragDetector dragDetector_;
-    ndk_helper::PerfMonitor monitor_;
-    double time_;
+    MonotonicClock clock_;
+    // Frame rate with "adb shell setprop debug.gunner.fps 30", the display's by default
+    FramePacer pacer_;
+    // Scene resolution follows the GPU time down to "adb shell setprop
+    // debug.gunner.minscale 0.5", 1 draws at full resolution
+    ResolutionScaler scaler_;
+    // Time from a tap to the swap that first shows its bullet
+    LatencyHistogram tapLatency_;
+    // Heap allocations made by the simulation and rendering of a frame
+    AllocFrameCounter frameAllocations_;
+    // Plays by itself with "adb shell setprop debug.gunner.autopilot 1"
+    bool autopilotOn_;
+    Autopilot autopilot_;
+    // Outlines get soft edges unless "adb shell setprop debug.gunner.aa 0"
+    bool antialias_;
 
     android_app* app_;
 
@@ -57,63 +82,43 @@ public:
     void termDisplay();
     void trimMemory();
     bool isReady();
-
-    void showUI();
-    void showScore(int score);
-    void showCenterText(string text);
+    int getPollTimeout();
 };
 
 //-------------------------------------------------------------------------
 //Ctor
 //-------------------------------------------------------------------------
 Engine::Engine() :
+                game_( NULL ),
                 initializedResources_( false ),
                 hasFocus_( false ),
-                app_( NULL ),
-                time_ ( 0 )
+                pacer_( &clock_ ),
+                autopilotOn_( false ),
+                antialias_( true ),
+                app_( NULL )
 {
     glContext_ = ndk_helper::GLContext::GetInstance();
-}
-
-void Engine::showUI()
-{
-    JNIEnv *jni;
-    app_->activity->vm->AttachCurrentThread( &jni, NULL );
-
-    //Default class retrieval
-    jclass clazz = jni->GetObjectClass( app_->activity->clazz );
-    jmethodID methodID = jni->GetMethodID( clazz, "showUI", "()V" );
-    jni->CallVoidMethod( app_->activity->clazz, methodID );
-
-    app_->activity->vm->DetachCurrentThread();
-    return;
-}
-
-void Engine::showScore(int score) {
-    JNIEnv *jni;
-    app_->activity->vm->AttachCurrentThread( &jni, NULL );
-
-    //Default class retrieval
-    jclass clazz = jni->GetObjectClass( app_->activity->clazz );
-    jmethodID methodID = jni->GetMethodID( clazz, "showScore", "(I)V" );
-    jni->CallVoidMethod( app_->activity->clazz, methodID, score);
-
-    app_->activity->vm->DetachCurrentThread();
-    return;
-}
-
-void Engine::showCenterText(string text) {
-    JNIEnv *jni;
-    app_->activity->vm->AttachCurrentThread( &jni, NULL );
-
-    jstring jtext = jni->NewStringUTF(text.c_str());
-    //Default class retrieval
-    jclass clazz = jni->GetObjectClass( app_->activity->clazz );
-    jmethodID methodID = jni->GetMethodID( clazz, "showCenterText", "(Ljava/lang/String;)V" );
-    jni->CallVoidMethod( app_->activity->clazz, methodID, jtext);
 
-    app_->activity->vm->DetachCurrentThread();
-    return;
+    char value[PROP_VALUE_MAX];
+    if( __system_property_get( "debug.gunner.autopilot", value ) > 0 && value[0] == '1' )
+    {
+        LOGI( "Autopilot is on" );
+        autopilotOn_ = true;
+    }
+    if( __system_property_get( "debug.gunner.fps", value ) > 0 )
+    {
+        pacer_.setTargetFps( atoi( value ) );
+        scaler_.setTargetFps( atoi( value ) );
+    }
+    if( __system_property_get( "debug.gunner.minscale", value ) > 0 )
+    {
+        scaler_.setLimits( atof( value ), 1.0f );
+    }
+    if( __system_property_get( "debug.gunner.aa", value ) > 0 && value[0] == '0' )
+    {
+        LOGI( "Antialiasing is off" );
+        antialias_ = false;
+    }
 }
 
 /**
@@ -135,9 +140,9 @@ int Engine::initDisplay()
         }
     }
 
-    showUI();
-
-    game_ = new Game(glContext_->GetScreenWidth(), glContext_->GetScreenHeight());
+    game_ = new Game(glContext_->GetScreenWidth(), glContext_->GetScreenHeight(), antialias_);
+    game_->setResolutionScaler( scaler_.getMinScale() < 1.0f ? &scaler_ : NULL );
+    pacer_.setIdle( false );
 
     LOGI("end init");
 
@@ -149,22 +154,73 @@ int Engine::initDisplay()
  */
 void Engine::drawFrame()
 {
-    double newTime = monitor_.GetCurrentTime();
-    double dt = time_ == 0 ? 0 : newTime - time_;
-    time_ = newTime;
+    TRACE_SCOPE( "Engine::drawFrame" );
+    double dt = pacer_.beginFrame();
+    int64_t newTime = pacer_.getFrameTime();
+
+    frameAllocations_.begin();
+    if( autopilotOn_ )
+    {
+        autopilot_.act( game_->getWorld(), newTime );
+    }
 
-    game_->work(dt);
-    showScore(game_->getScore());
+    // Score and messages are drawn by the game itself
+    game_->work(dt, newTime);
+    frameAllocations_.end();
 
     // Swap
-    if( EGL_SUCCESS != glContext_->Swap() )
     {
-        LOGI("GLContext::Swap failed");
+        TRACE_SCOPE( "Swap" );
+        if( EGL_SUCCESS != glContext_->Swap() )
+        {
+            LOGI("GLContext::Swap failed");
+        }
     }
 
-    if (game_->isOver()) {
-        showCenterText(game_->getGameOverText());
-        hasFocus_ = false;
+    const vector<int64_t>& shownTaps = game_->getShownTaps();
+    if( !shownTaps.empty() )
+    {
+        int64_t swapTime = monotonicNanos();
+        for( size_t i = 0; i < shownTaps.size(); ++i )
+        {
+            tapLatency_.add( swapTime - shownTaps[i] );
+        }
+        if( tapLatency_.getCount() % 100 < shownTaps.size() )
+        {
+            tapLatency_.log( "Input to display" );
+        }
+    }
+
+    if (game_->isOver() && !pacer_.isIdle()) {
+        tapLatency_.log( "Input to display" );
+        frameAllocations_.log( "Heap" );
+        frameAllocations_.reset();
+        pacer_.log( "Frames" );
+        pacer_.resetStats();
+        scaler_.log( "Resolution" );
+        scaler_.resetStats();
+        if( autopilotOn_ )
+        {
+            // Keep the session going with a new game
+            LOGI( "Autopilot scored %d, %u taps, %u dodges", game_->getScore(),
+                autopilot_.getTaps(), autopilot_.getDodges() );
+            delete game_;
+            game_ = new Game( glContext_->GetScreenWidth(), glContext_->GetScreenHeight(), antialias_ );
+            game_->setResolutionScaler( scaler_.getMinScale() < 1.0f ? &scaler_ : NULL );
+            autopilot_.reset();
+        }
+        else
+        {
+            // The last frame stays on screen, wait for events until it needs drawing again
+            pacer_.setIdle( true );
+        }
+    }
+    else if( !autopilotOn_ && game_->getWorld().isStatic() )
+    {
+        // Only the shuttle is left, skip frames until the next spawn or a tap
+        World& world = game_->getWorld();
+        double wait = world.getNextSpawn() - world.getTime();
+        pacer_.hold( (int64_t) (fmin( wait < 0.0 ? MAX_HOLD : wait, MAX_HOLD ) * 1e9) );
     }
 }
 
@@ -175,12 +231,20 @@ void Engine::termDisplay()
 {
     glContext_->Suspend();
     delete game_;
+    game_ = NULL;
 }
 
+/**
+ * Shed load on the CPU side. The EGL context stays, the game holds GL
+ * objects in it and keeps drawing with them.
+ */
 void Engine::trimMemory()
 {
     LOGI( "Trimming memory" );
-    glContext_->Invalidate();
+    if( game_ != NULL )
+    {
+        game_->trimMemory();
+    }
 }
 /**
  * Process the next input event.
@@ -195,7 +259,7 @@ int32_t Engine::handleInput( android_app* app, AInputEvent* event )
 
     ndk_helper::GESTURE_STATE dragState = eng->dragDetector_.Detect( event );
 
-    if( dragState == ndk_helper::GESTURE_STATE_START )
+    if( dragState == ndk_helper::GESTURE_STATE_START && eng->game_ != NULL && !eng->game_->isOver() )
     {
         ndk_helper::Vec2 v;
         eng->dragDetector_.GetPointer( v );
@@ -204,7 +268,10 @@ int32_t Engine::handleInput( android_app* app, AInputEvent* event )
         float x, y;
         v.Value(x, y);
 
-        eng->game_->tap(x, y);
+        // The game applies the tap at the moment it really happened
+        eng->game_->getInput().push( x, y, AMotionEvent_getEventTime( event ) );
+        // A static screen changes with the shot
+        eng->pacer_.invalidate();
     }
 
     return 1;
@@ -243,16 +310,19 @@ void Engine::handleCmd( struct android_app* app, int32_t cmd )
         LOGI("APP_CMD_GAINED_FOCUS");
         //Start animation
         eng->hasFocus_ = true;
+        // The pause isn't played, and an idle screen is drawn again
+        eng->pacer_.restart();
+        eng->pacer_.invalidate();
         break;
     case APP_CMD_LOST_FOCUS:
         LOGI("APP_CMD_LOST_FOCUS");
-        // Also stop animating.
+        // Also stop animating. The world stands still and the last frame
+        // stays on screen, so nothing is drawn until focus comes back.
         eng->hasFocus_ = false;
-        eng->drawFrame();
         break;
     case APP_CMD_LOW_MEMORY:
         LOGI("APP_CMD_LOW_MEMORY");
-        //Free up GL resources
+        // Shed nodes and debris, GL resources are kept
         eng->trimMemory();
         break;
     }
@@ -269,10 +339,12 @@ void Engine::setState( android_app* state )
 
 bool Engine::isReady()
 {
-    if( hasFocus_ )
-        return true;
+    return game_ != NULL && pacer_.isFrameDue( hasFocus_ );
+}
 
-    return false;
+int Engine::getPollTimeout()
+{
+    return pacer_.getTimeout( hasFocus_ && game_ != NULL );
 }
 
 void Engine::transformPosition( ndk_helper::Vec2& vec )
@@ -298,6 +370,16 @@ void android_main( android_app* state )
     //Init helper functions
     ndk_helper::JNIHelper::Init( state->activity, HELPER_CLASS_NAME );
 
+    // Pick geometry kernels for this CPU
+    initKernels();
+
+    // "adb shell setprop debug.gunner.trace /sdcard/gunner.json" records a trace
+    char tracePath[PROP_VALUE_MAX];
+    if( __system_property_get( "debug.gunner.trace", tracePath ) > 0 && traceStart( tracePath ) )
+    {
+        traceThreadName( "main" );
+    }
+
     state->userData = &g_engine;
     state->onAppCmd = Engine::handleCmd;
     state->onInputEvent = Engine::handleInput;
@@ -315,9 +397,9 @@ void android_main( android_app* state )
         android_poll_source* source;
 
         // If not animating, we will block forever waiting for events.
-        // If animating, we loop until all events are read, then continue
-        // to draw the next frame of animation.
-        while( (id = ALooper_pollAll( g_engine.isReady() ? 0 : -1, NULL, &events, (void**) &source ))
+        // If animating, we loop until all events are read and the next
+        // frame is due, then continue to draw it.
+        while( (id = ALooper_pollAll( g_engine.getPollTimeout(), NULL, &events, (void**) &source ))
                 >= 0 )
         {
             // Process this event.
@@ -328,14 +410,15 @@ void android_main( android_app* state )
             if( state->destroyRequested != 0 )
             {
                 g_engine.termDisplay();
+                traceStop();
                 return;
             }
         }
 
         if( g_engine.isReady() )
         {
-            // Drawing is throttled to the screen update rate, so there
-            // is no need to do timing here.
+            // The pacer holds frames back to the target rate, beyond
+            // that drawing is throttled to the screen update rate.
             g_engine.drawFrame();
         }
 
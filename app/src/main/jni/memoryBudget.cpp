@@ -0,0 +1,66 @@
+#include "memoryBudget.h"
+
+#include <string.h>
+
+MemoryBudget::MemoryBudget()
+    : limit_(0)
+{
+    memset(&stats_, 0, sizeof(stats_));
+
+    // Meteor caps add up to the capacity of the GPU meteor batch
+    caps_[NODE] = 0;
+    caps_[SHUTTLE] = 1;
+    caps_[BULLET] = 64;
+    caps_[METEOR] = 32;
+    caps_[SMALL_METEOR] = 96;
+}
+
+void MemoryBudget::update() {
+    stats_.currentBytes = stats_.nodeBytes + stats_.storageBytes + stats_.gpuBytes;
+    if (stats_.currentBytes > stats_.peakBytes) {
+        stats_.peakBytes = stats_.currentBytes;
+    }
+}
+
+// True if no more nodes of this type are allowed
+bool MemoryBudget::isCapped(NodeType type) {
+    return stats_.count[type] >= caps_[type];
+}
+
+// True if a node of this type and size fits both its cap and the limit,
+// otherwise the node counts as refused
+bool MemoryBudget::canAdd(NodeType type, size_t bytes) {
+    if (!isCapped(type) && (limit_ == 0 || stats_.currentBytes + bytes <= limit_)) { return true; }
+
+    stats_.refused++;
+    return false;
+}
+
+void MemoryBudget::add(NodeType type, size_t bytes) {
+    stats_.count[type]++;
+    stats_.bytes[type] += bytes;
+    stats_.nodeBytes += bytes;
+    update();
+}
+
+void MemoryBudget::release(NodeType type, size_t bytes) {
+    stats_.count[type]--;
+    stats_.bytes[type] -= bytes;
+    stats_.nodeBytes -= bytes;
+    update();
+}
+
+void MemoryBudget::setStorage(size_t bytes) {
+    stats_.storageBytes = bytes;
+    update();
+}
+
+void MemoryBudget::setGpuStorage(size_t bytes) {
+    stats_.gpuBytes = bytes;
+    update();
+}
+
+void MemoryBudget::recordShed(int nodes) {
+    stats_.shedEvents++;
+    stats_.shedNodes += nodes;
+}
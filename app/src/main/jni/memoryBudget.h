@@ -0,0 +1,54 @@
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+#include <stddef.h>
+
+#include "node.h"
+
+// Snapshot of the memory held by the game
+struct MemoryStats {
+    // Nodes and their geometry
+    size_t nodeBytes;
+    // Containers of the world and the free part of its node pool
+    size_t storageBytes;
+    // Vertex buffers owned by the renderer
+    size_t gpuBytes;
+    size_t currentBytes;
+    size_t peakBytes;
+    // Times memory was shed and nodes dropped while doing it
+    int shedEvents;
+    int shedNodes;
+    // Spawns refused because of a cap or the limit
+    int refused;
+    int count[NODE_TYPES];
+    size_t bytes[NODE_TYPES];
+};
+
+// Accounts entity and geometry memory and enforces per type caps
+// and an optional hard byte limit.
+class MemoryBudget {
+    MemoryStats stats_;
+    int caps_[NODE_TYPES];
+    size_t limit_;
+
+    void update();
+
+public:
+    MemoryBudget();
+    void setCap(NodeType type, int count) { caps_[type] = count; }
+    int getCap(NodeType type) { return caps_[type]; }
+    void setLimit(size_t bytes) { limit_ = bytes; }
+    size_t getLimit() { return limit_; }
+
+    bool isCapped(NodeType type);
+    bool canAdd(NodeType type, size_t bytes);
+    void add(NodeType type, size_t bytes);
+    void release(NodeType type, size_t bytes);
+    void setStorage(size_t bytes);
+    void setGpuStorage(size_t bytes);
+    void recordShed(int nodes);
+    void recordRefused() { stats_.refused++; }
+    const MemoryStats& getStats() { return stats_; }
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef METEOR_H
+#define METEOR_H
+
+#include "node.h"
+
+#define MAX_VERTEX_COUNT 10
+#define MIN_VERTEX_COUNT 4
+
+// Shape sequences of the ShapeFactory. Small meteors draw from their own,
+// so hits don't change the shapes of the meteors spawned after them.
+enum ShapeStream {
+    SHAPES_METEOR,
+    SHAPES_SMALL_METEOR,
+    SHAPE_STREAMS
+};
+
+class ShapeFactory;
+class Random;
+
+class Meteor: public Node {
+
+    // All speeds are per second, so the motion is a pure function of time
+    float xFallSpeed_;
+    float yFallSpeed_;
+    float rotateSpeed_;
+    float spawnX_;
+    float spawnY_;
+    double spawnTime_;
+    int batchSlot_;
+    int outlineSlot_;
+    int16_t vertexStorage_[MAX_VERTEX_COUNT * DIMENTIONS];
+    uint8_t colorStorage_[MAX_VERTEX_COUNT * COLOR_COMPONENTS];
+    static const float maxFallSpeed;
+    static const float minFallSpeed;
+    static const float maxXSpeed;
+    static const float rotateSpeedRange;
+
+public:
+    Meteor(ShapeFactory& shapes, Random& random, ShapeStream stream = SHAPES_METEOR);
+    NodeType getType() { return METEOR; };
+    size_t getFootprint() { return sizeof(*this); };
+    bool isOut();
+    float getXFallSpeed() { return xFallSpeed_; }
+    float getYFallSpeed() { return yFallSpeed_; }
+    float getRotateSpeed() { return rotateSpeed_; }
+    float getSpawnX() { return spawnX_; }
+    float getSpawnY() { return spawnY_; }
+    double getSpawnTime() { return spawnTime_; }
+    int getBatchSlot() { return batchSlot_; }
+    void setBatchSlot(int slot) { batchSlot_ = slot; }
+    int getOutlineSlot() { return outlineSlot_; }
+    void setOutlineSlot(int slot) { outlineSlot_ = slot; }
+    void updateXSpeed(Random& random);
+    // The first draw of a meteor from its random
+    static int randomVertexCount(Random& random);
+    void launch(float x, float y, double time, Random& random);
+    void updateAt(double time);
+    double getExitTime();
+    double getThreatTime(float y);
+};
+
+#endif
@@ -0,0 +1,158 @@
+#include "meteorBatch.h"
+
+#include <string.h>
+
+#include "glUtil.h"
+
+using namespace ndk_helper;
+
+const char gMeteorVertexShader[] =
+    "uniform highp mat4 uViewProj;\n"
+    "uniform highp float uTime;\n"
+    "attribute vec2 aPosition;\n"
+    "attribute vec4 aColor;\n"
+    "attribute highp vec4 aOrigin;\n"
+    "attribute highp vec3 aMotion;\n"
+    "varying vec4 vColor;\n"
+    "void main() {\n"
+    "  vColor = aColor;\n"
+    "  if (aOrigin.z < 0.0) {\n"
+    "    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);\n"
+    "    return;\n"
+    "  }\n"
+    "  highp float t = uTime - aOrigin.z;\n"
+    "  highp float a = aMotion.z * t;\n"
+    "  highp float c = cos(a);\n"
+    "  highp float s = sin(a);\n"
+    "  highp vec2 q = aPosition * aOrigin.w;\n"
+    "  highp vec2 p = vec2(c * q.x - s * q.y, s * q.x + c * q.y);\n"
+    "  p += aOrigin.xy + aMotion.xy * t;\n"
+    "  gl_Position = uViewProj * vec4(p, 0, 1);\n"
+    "}\n";
+
+MeteorBatch::MeteorBatch(GLuint program, Mat4 mVP, float halfWidth, float fringe)
+    : program_(program), vbo_(0), freeCount_(0), highWater_(0), halfWidth_(halfWidth),
+    fringe_(fringe)
+{
+    aPositionHandle_ = glGetAttribLocation(program_, "aPosition");
+    aColorHandle_ = glGetAttribLocation(program_, "aColor");
+    aOriginHandle_ = glGetAttribLocation(program_, "aOrigin");
+    aMotionHandle_ = glGetAttribLocation(program_, "aMotion");
+    uViewProjHandle_ = glGetUniformLocation(program_, "uViewProj");
+    uTimeHandle_ = glGetUniformLocation(program_, "uTime");
+    checkGlError("MeteorBatch locations");
+
+    // Projection never changes, so set it once
+    glUseProgram(program_);
+    glUniformMatrix4fv(uViewProjHandle_, 1, GL_FALSE, mVP.Ptr());
+    checkGlError("glUniformMatrix4fv");
+
+    // Unused vertices carry a negative spawn time and get clipped away
+    memset(empty_, 0, sizeof(empty_));
+    for (int i = 0; i < BATCH_SLOT_VERTICES; ++i) {
+        empty_[i].origin[2] = -1.0f;
+    }
+
+    // Hand out low slots first to keep the drawn range short
+    for (int i = BATCH_CAPACITY - 1; i >= 0; --i) {
+        freeSlots_[freeCount_++] = i;
+        used_[i] = false;
+    }
+
+    glGenBuffers(1, &vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(MeteorVertex) * BATCH_SLOT_VERTICES * BATCH_CAPACITY,
+        NULL, GL_STATIC_DRAW);
+    for (int i = 0; i < BATCH_CAPACITY; ++i) {
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(empty_) * i, sizeof(empty_), empty_);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    checkGlError("MeteorBatch buffer");
+}
+
+// Uploads the meteor once. Returns its slot or -1 if the batch is full.
+int MeteorBatch::add(Meteor* meteor) {
+    if (freeCount_ == 0 || meteor->getVertices() == NULL) { return -1; }
+
+    int slot = freeSlots_[--freeCount_];
+    used_[slot] = true;
+    if (slot >= highWater_) { highWater_ = slot + 1; }
+
+    // Meteors scale the same way along both axes
+    float scale = meteor->getScaleX();
+    int count = buildOutline(meteor->getVertices(), meteor->getColors(), meteor->getVertexCount(),
+        scale, scale, halfWidth_, fringe_, outline_);
+
+    // The stroke is padded with its last vertex, so every slot chains into
+    // the next one with degenerate triangles and all go in one draw call
+    memcpy(slot_, empty_, sizeof(slot_));
+    for (int i = 0; i < BATCH_SLOT_VERTICES && count > 0; ++i) {
+        const OutlineVertex& src = outline_[i < count ? i : count - 1];
+        MeteorVertex& v = slot_[i];
+        v.position[0] = src.position[0];
+        v.position[1] = src.position[1];
+        memcpy(v.color, src.color, sizeof(v.color));
+        v.origin[0] = meteor->getSpawnX();
+        v.origin[1] = meteor->getSpawnY();
+        v.origin[2] = (GLfloat) meteor->getSpawnTime();
+        v.origin[3] = scale * OUTLINE_RANGE;
+        v.motion[0] = meteor->getXFallSpeed();
+        v.motion[1] = meteor->getYFallSpeed();
+        v.motion[2] = meteor->getRotateSpeed();
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferSubData(GL_ARRAY_BUFFER, sizeof(slot_) * slot, sizeof(slot_), slot_);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    checkGlError("glBufferSubData");
+
+    return slot;
+}
+
+void MeteorBatch::remove(int slot) {
+    if (slot < 0 || slot >= BATCH_CAPACITY || !used_[slot]) { return; }
+
+    used_[slot] = false;
+    freeSlots_[freeCount_++] = slot;
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferSubData(GL_ARRAY_BUFFER, sizeof(empty_) * slot, sizeof(empty_), empty_);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    checkGlError("glBufferSubData");
+
+    while (highWater_ > 0 && !used_[highWater_ - 1]) { --highWater_; }
+}
+
+void MeteorBatch::draw(double time) {
+    if (highWater_ == 0) { return; }
+
+    glUseProgram(program_);
+    glUniform1f(uTimeHandle_, (GLfloat) time);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glVertexAttribPointer(aPositionHandle_, DIMENTIONS, GL_SHORT, GL_TRUE,
+        sizeof(MeteorVertex), (const GLvoid*) offsetof(MeteorVertex, position));
+    glVertexAttribPointer(aColorHandle_, COLOR_COMPONENTS, GL_UNSIGNED_BYTE, GL_TRUE,
+        sizeof(MeteorVertex), (const GLvoid*) offsetof(MeteorVertex, color));
+    glVertexAttribPointer(aOriginHandle_, 4, GL_FLOAT, GL_FALSE,
+        sizeof(MeteorVertex), (const GLvoid*) offsetof(MeteorVertex, origin));
+    glVertexAttribPointer(aMotionHandle_, 3, GL_FLOAT, GL_FALSE,
+        sizeof(MeteorVertex), (const GLvoid*) offsetof(MeteorVertex, motion));
+    glEnableVertexAttribArray(aPositionHandle_);
+    glEnableVertexAttribArray(aColorHandle_);
+    glEnableVertexAttribArray(aOriginHandle_);
+    glEnableVertexAttribArray(aMotionHandle_);
+    checkGlError("MeteorBatch attributes");
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, highWater_ * BATCH_SLOT_VERTICES);
+    checkGlError("glDrawArrays");
+
+    // Leave client side arrays usable for the rest of the scene
+    glDisableVertexAttribArray(aOriginHandle_);
+    glDisableVertexAttribArray(aMotionHandle_);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+MeteorBatch::~MeteorBatch() {
+    if (vbo_) { glDeleteBuffers(1, &vbo_); }
+}
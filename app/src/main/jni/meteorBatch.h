@@ -0,0 +1,60 @@
+#ifndef METEOR_BATCH_H
+#define METEOR_BATCH_H
+
+#include <GLES2/gl2.h>
+#include <vecmath.h>
+#include <stddef.h>
+
+#include "meteor.h"
+#include "outline.h"
+
+// Every meteor owns a fixed slot of outline strip vertices in one static buffer
+#define BATCH_CAPACITY 128
+#define BATCH_SLOT_VERTICES OUTLINE_MAX_VERTICES(MAX_VERTEX_COUNT)
+
+// Vertex of the analytic meteor batch, geometry in the compact format of the node.
+// The shader computes the meteor transform from origin, motion and uTime.
+struct MeteorVertex {
+    GLshort position[DIMENTIONS];
+    GLubyte color[COLOR_COMPONENTS];
+    GLfloat origin[4];  // spawn x, spawn y, spawn time, scale times OUTLINE_RANGE
+    GLfloat motion[3];  // x speed, y speed, rotate speed
+};
+
+extern const char gMeteorVertexShader[];
+
+class MeteorBatch {
+    GLuint program_;
+    GLuint vbo_;
+    GLuint aPositionHandle_;
+    GLuint aColorHandle_;
+    GLuint aOriginHandle_;
+    GLuint aMotionHandle_;
+    GLuint uViewProjHandle_;
+    GLuint uTimeHandle_;
+
+    int freeSlots_[BATCH_CAPACITY];
+    int freeCount_;
+    bool used_[BATCH_CAPACITY];
+    // Slots past this one are never drawn
+    int highWater_;
+    // Stroke in playfield units
+    float halfWidth_;
+    float fringe_;
+
+    OutlineVertex outline_[BATCH_SLOT_VERTICES];
+    MeteorVertex slot_[BATCH_SLOT_VERTICES];
+    MeteorVertex empty_[BATCH_SLOT_VERTICES];
+
+public:
+    MeteorBatch(GLuint program, ndk_helper::Mat4 mVP, float halfWidth, float fringe);
+    ~MeteorBatch();
+    int add(Meteor* meteor);
+    void remove(int slot);
+    void draw(double time);
+    size_t getBufferBytes() {
+        return sizeof(MeteorVertex) * BATCH_SLOT_VERTICES * BATCH_CAPACITY + sizeof(*this);
+    }
+};
+
+#endif
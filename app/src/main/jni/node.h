@@ -0,0 +1,93 @@
+#ifndef NODE_H
+#define NODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "vertexFormat.h"
+
+#define DIMENTIONS 2
+#define COLOR_COMPONENTS 4
+#define XMIN -1.0f
+#define XMAX 1.0
+#define YMIN -1.0
+#define YMAX 1.0f
+
+enum NodeType {
+    NODE,
+    SHUTTLE,
+    BULLET,
+    METEOR,
+    SMALL_METEOR,
+    NODE_TYPES
+};
+
+// Predicted moments in a node's life, see EventQueue
+enum EventType {
+    // The node leaves the playfield
+    EVENT_EXIT,
+    // The node can touch the shuttle from now on
+    EVENT_THREAT,
+    EVENT_TYPES
+};
+
+class Node {
+
+protected:
+    // Point into arrays of the subclass, so a node is one allocation.
+    // Vertices are unit geometry, see vertexFormat.h, scaled by scaleX_ and scaleY_.
+    int16_t* vertices_;
+    uint8_t* colors_;
+    int vertexCount_;
+    float scaleX_;
+    float scaleY_;
+    float x_;
+    float y_;
+    float angle_;
+    bool removed_;
+    int eventIndex_[EVENT_TYPES];
+    virtual void scale(float, float);
+
+public:
+    Node():
+        vertices_(NULL),
+        colors_(NULL),
+        vertexCount_(0),
+        scaleX_(1.0f), scaleY_(1.0f),
+        x_(0.0f), y_(0.0f),
+        angle_(0.0f),
+        removed_(false) {
+        for (int i = 0; i < EVENT_TYPES; ++i) { eventIndex_[i] = -1; }
+    };
+    virtual ~Node();
+    virtual void translate(float, float);
+    virtual void rotate(float);
+    int getVertexCount() {return vertexCount_;};
+    const int16_t* getVertices() { return vertices_; };
+    const uint8_t* getColors() { return colors_; };
+    float getScaleX() { return scaleX_; };
+    float getScaleY() { return scaleY_; };
+    // Vertex i relative to the node's position, dequantized
+    void getVertex(int i, float& x, float& y) {
+        x = dequantizePosition(vertices_[i * 2]) * scaleX_;
+        y = dequantizePosition(vertices_[i * 2 + 1]) * scaleY_;
+    };
+    virtual NodeType getType() { return NODE; };
+    // Bytes held by the node, its geometry is stored inline
+    virtual size_t getFootprint() { return sizeof(*this); };
+    virtual bool isOut();
+    float getX() { return x_; };
+    float getY() { return y_; };
+    float getAngle() { return angle_; };
+
+    bool isInside(float, float);
+    void getBounds(float& xmin, float& xmax, float& ymin, float& ymax);
+
+    // Removed nodes are skipped by the world and deleted at the end of the step
+    void markRemoved() { removed_ = true; };
+    bool isRemoved() { return removed_; };
+    int getEventIndex(EventType type) { return eventIndex_[type]; };
+    void setEventIndex(EventType type, int index) { eventIndex_[type] = index; };
+};
+
+#endif
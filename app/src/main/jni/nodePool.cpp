@@ -0,0 +1,37 @@
+#include "nodePool.h"
+
+#include <stdlib.h>
+
+NodePool::NodePool(size_t slotSize, int capacity)
+    : free_(NULL), capacity_(capacity), used_(0)
+{
+    // Slots hold a free list link while unused and doubles once taken
+    slotSize_ = (slotSize + 15) & ~(size_t) 15;
+    storage_ = (char*) malloc(slotSize_ * capacity_);
+    if (storage_ == NULL) { capacity_ = 0; }
+
+    for (int i = capacity_ - 1; i >= 0; --i) {
+        void* slot = storage_ + slotSize_ * i;
+        *(void**) slot = free_;
+        free_ = slot;
+    }
+}
+
+void* NodePool::allocate() {
+    if (free_ == NULL) { return NULL; }
+
+    void* slot = free_;
+    free_ = *(void**) slot;
+    used_++;
+    return slot;
+}
+
+void NodePool::release(void* slot) {
+    *(void**) slot = free_;
+    free_ = slot;
+    used_--;
+}
+
+NodePool::~NodePool() {
+    free(storage_);
+}
@@ -0,0 +1,31 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <stddef.h>
+
+// Default caps of bullets, meteors and small meteors add up to this
+#define NODE_POOL_CAPACITY 192
+
+// Fixed size slots for the nodes a world spawns while playing. Nodes are
+// built in a slot with placement new, so spawning never touches the heap.
+class NodePool {
+    char* storage_;
+    void* free_;
+    size_t slotSize_;
+    int capacity_;
+    int used_;
+
+public:
+    NodePool(size_t slotSize, int capacity);
+    ~NodePool();
+    // NULL when every slot is taken
+    void* allocate();
+    void release(void* slot);
+    bool owns(void* slot) {
+        return (char*) slot >= storage_ && (char*) slot < storage_ + slotSize_ * capacity_;
+    }
+    size_t getSlotSize() { return slotSize_; }
+    size_t getFreeBytes() { return (capacity_ - used_) * slotSize_; }
+};
+
+#endif
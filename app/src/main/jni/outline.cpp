@@ -0,0 +1,108 @@
+#include "outline.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "meteor.h"
+
+// Corner i of the polygon in playfield units and its miter, the offset
+// of the stroke edge per unit of width
+struct Corner {
+    float x;
+    float y;
+    float mx;
+    float my;
+};
+
+// Unit normal of the edge from a to b, or none if they coincide
+static bool edgeNormal(const Corner& a, const Corner& b, float& nx, float& ny) {
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length < 1e-9f) { return false; }
+
+    nx = dy / length;
+    ny = -dx / length;
+    return true;
+}
+
+// Writes the corner moved by offset along its miter, with alpha scaled
+static void emit(const Corner& corner, const uint8_t* color, float offset, float alpha,
+    float rangeX, float rangeY, OutlineVertex& out) {
+    out.position[0] = quantizePosition((corner.x + corner.mx * offset) / rangeX);
+    out.position[1] = quantizePosition((corner.y + corner.my * offset) / rangeY);
+    memcpy(out.color, color, sizeof(out.color));
+    out.color[3] = (uint8_t) (color[3] * alpha + 0.5f);
+}
+
+// One strip between two offsets along the miters, around the whole polygon
+static int strip(const Corner* corners, const uint8_t* colors, int count,
+    float outer, float outerAlpha, float inner, float innerAlpha,
+    float rangeX, float rangeY, OutlineVertex* out) {
+    int k = 0;
+    for (int j = 0; j <= count; ++j) {
+        int i = j % count;
+        const uint8_t* color = colors + i * COLOR_COMPONENTS;
+        emit(corners[i], color, outer, outerAlpha, rangeX, rangeY, out[k++]);
+        // Repeat the first vertex, the previous strip ends on a degenerate triangle
+        if (j == 0) {
+            out[k] = out[k - 1];
+            k++;
+        }
+        emit(corners[i], color, inner, innerAlpha, rangeX, rangeY, out[k++]);
+    }
+    out[k] = out[k - 1];
+    return k + 1;
+}
+
+int buildOutline(const int16_t* vertices, const uint8_t* colors, int count,
+    float sx, float sy, float halfWidth, float fringe, OutlineVertex* out) {
+    if (count < 2) { return 0; }
+
+    Corner corners[MAX_VERTEX_COUNT];
+    if (count > MAX_VERTEX_COUNT) { count = MAX_VERTEX_COUNT; }
+    for (int i = 0; i < count; ++i) {
+        corners[i].x = dequantizePosition(vertices[i * 2]) * sx;
+        corners[i].y = dequantizePosition(vertices[i * 2 + 1]) * sy;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const Corner& prev = corners[(i + count - 1) % count];
+        const Corner& next = corners[(i + 1) % count];
+        Corner& corner = corners[i];
+
+        float n0x = 0.0f, n0y = 0.0f, n1x = 0.0f, n1y = 0.0f;
+        bool hasPrev = edgeNormal(prev, corner, n0x, n0y);
+        bool hasNext = edgeNormal(corner, next, n1x, n1y);
+        if (!hasPrev) { n0x = n1x; n0y = n1y; }
+        if (!hasNext) { n1x = n0x; n1y = n0y; }
+
+        // The miter halves the corner and reaches the offset edges where they meet
+        float mx = n0x + n1x;
+        float my = n0y + n1y;
+        float length = sqrtf(mx * mx + my * my);
+        if (length < 1e-6f) {
+            // The polygon turns back on itself
+            mx = n0x;
+            my = n0y;
+        } else {
+            mx /= length;
+            my /= length;
+        }
+        float cosHalf = mx * n0x + my * n0y;
+        float miter = cosHalf > 1.0f / OUTLINE_MITER_LIMIT ? 1.0f / cosHalf : OUTLINE_MITER_LIMIT;
+        corner.mx = mx * miter;
+        corner.my = my * miter;
+    }
+
+    float rangeX = sx * OUTLINE_RANGE;
+    float rangeY = sy * OUTLINE_RANGE;
+    int k = strip(corners, colors, count, halfWidth, 1.0f, -halfWidth, 1.0f, rangeX, rangeY, out);
+    if (fringe > 0.0f) {
+        k += strip(corners, colors, count, halfWidth + fringe, 0.0f, halfWidth, 1.0f,
+            rangeX, rangeY, out + k);
+        k += strip(corners, colors, count, -halfWidth, 1.0f, -halfWidth - fringe, 0.0f,
+            rangeX, rangeY, out + k);
+    }
+    return k;
+}
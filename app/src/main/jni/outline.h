@@ -0,0 +1,30 @@
+#ifndef OUTLINE_H
+#define OUTLINE_H
+
+#include <stdint.h>
+
+#include "node.h"
+
+// Outline vertices are unit geometry like the node's, over this range so
+// the stroke around a unit polygon still fits the normalized shorts
+#define OUTLINE_RANGE 2.0f
+// Longest miter in half widths, sharper corners get it clipped
+#define OUTLINE_MITER_LIMIT 4.0f
+// Strip vertices of a polygon with count vertices, with the antialiased fringes
+#define OUTLINE_MAX_VERTICES(count) (6 * (count) + 12)
+
+struct OutlineVertex {
+    int16_t position[DIMENTIONS];
+    uint8_t color[COLOR_COMPONENTS];
+};
+
+// Strokes the closed polygon of count quantized vertices scaled by (sx, sy)
+// as a triangle strip of constant width with mitered joins. The stroke is
+// halfWidth to either side of the edges, plus a fringe fading out to no
+// alpha on both sides, none if fringe is 0. Halves are in playfield units.
+// The strip starts and ends with a repeated vertex, so strips are chained
+// into one draw by degenerate triangles. Returns the vertices written.
+int buildOutline(const int16_t* vertices, const uint8_t* colors, int count,
+    float sx, float sy, float halfWidth, float fringe, OutlineVertex* out);
+
+#endif
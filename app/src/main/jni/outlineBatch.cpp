@@ -0,0 +1,95 @@
+#include "outlineBatch.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "glUtil.h"
+
+OutlineBatch::OutlineBatch(float halfWidth, float fringe, float aspect)
+    : halfWidth_(halfWidth), fringe_(fringe), range_(fmaxf(OUTLINE_RANGE, aspect + 1.0f)),
+    freeCount_(0), count_(0)
+{
+    memset(sharedCount_, 0, sizeof(sharedCount_));
+    // Hand out low slots first, as the meteor batch does
+    for (int i = NODE_POOL_CAPACITY - 1; i >= 0; --i) {
+        freeSlots_[freeCount_++] = i;
+        cacheCount_[i] = 0;
+    }
+}
+
+int OutlineBatch::cache(Meteor* meteor) {
+    if (freeCount_ == 0 || meteor->getVertices() == NULL) { return -1; }
+
+    int slot = freeSlots_[--freeCount_];
+    cacheCount_[slot] = buildOutline(meteor->getVertices(), meteor->getColors(),
+        meteor->getVertexCount(), meteor->getScaleX(), meteor->getScaleY(),
+        halfWidth_, fringe_, cache_[slot]);
+    return slot;
+}
+
+void OutlineBatch::forget(int slot) {
+    if (slot < 0 || slot >= NODE_POOL_CAPACITY || cacheCount_[slot] == 0) { return; }
+
+    cacheCount_[slot] = 0;
+    freeSlots_[freeCount_++] = slot;
+}
+
+void OutlineBatch::add(Node* node) {
+    if (node->getVertices() == NULL) { return; }
+
+    // Every bullet and the shuttle look the same, so their strokes are kept
+    NodeType type = node->getType();
+    const OutlineVertex* stroke = scratch_;
+    int count;
+    if (type == BULLET || type == SHUTTLE) {
+        if (sharedCount_[type] == 0) {
+            sharedCount_[type] = buildOutline(node->getVertices(), node->getColors(),
+                node->getVertexCount(), node->getScaleX(), node->getScaleY(),
+                halfWidth_, fringe_, shared_[type]);
+        }
+        stroke = shared_[type];
+        count = sharedCount_[type];
+    } else if ((type == METEOR || type == SMALL_METEOR) && ((Meteor*) node)->getOutlineSlot() >= 0) {
+        int slot = ((Meteor*) node)->getOutlineSlot();
+        stroke = cache_[slot];
+        count = cacheCount_[slot];
+    } else {
+        count = buildOutline(node->getVertices(), node->getColors(), node->getVertexCount(),
+            node->getScaleX(), node->getScaleY(), halfWidth_, fringe_, scratch_);
+    }
+    if (count_ + count > OUTLINE_BATCH_VERTICES) { return; }
+
+    // Stroke positions are over OUTLINE_RANGE around the scaled node,
+    // batch positions over the batch range around the playfield
+    float sx = node->getScaleX() * OUTLINE_RANGE / range_;
+    float sy = node->getScaleY() * OUTLINE_RANGE / range_;
+    float c = cosf(node->getAngle());
+    float s = sinf(node->getAngle());
+    float x = node->getX() / range_;
+    float y = node->getY() / range_;
+    for (int i = 0; i < count; ++i) {
+        float px = dequantizePosition(stroke[i].position[0]) * sx;
+        float py = dequantizePosition(stroke[i].position[1]) * sy;
+
+        OutlineBatchVertex& v = vertices_[count_ + i];
+        v.position[0] = quantizePosition(c * px - s * py + x);
+        v.position[1] = quantizePosition(s * px + c * py + y);
+        memcpy(v.color, stroke[i].color, sizeof(v.color));
+    }
+    count_ += count;
+}
+
+void OutlineBatch::draw(GLuint hPos, GLuint hCol) {
+    if (count_ == 0) { return; }
+
+    glVertexAttribPointer(hPos, DIMENTIONS, GL_SHORT, GL_TRUE,
+        sizeof(OutlineBatchVertex), vertices_[0].position);
+    glEnableVertexAttribArray(hPos);
+    glVertexAttribPointer(hCol, COLOR_COMPONENTS, GL_UNSIGNED_BYTE, GL_TRUE,
+        sizeof(OutlineBatchVertex), vertices_[0].color);
+    glEnableVertexAttribArray(hCol);
+    checkGlError("OutlineBatch attributes");
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, count_);
+    checkGlError("glDrawArrays");
+}
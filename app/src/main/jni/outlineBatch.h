@@ -0,0 +1,55 @@
+#ifndef OUTLINE_BATCH_H
+#define OUTLINE_BATCH_H
+
+#include <GLES2/gl2.h>
+#include <stddef.h>
+
+#include "outline.h"
+#include "meteor.h"
+#include "nodePool.h"
+
+// Every node the world can hold, at the most vertices a stroke takes
+#define OUTLINE_BATCH_VERTICES ((NODE_POOL_CAPACITY + 1) * OUTLINE_MAX_VERTICES(MAX_VERTEX_COUNT))
+
+// Vertex of the outline batch, in the playfield over the batch range
+struct OutlineBatchVertex {
+    GLshort position[DIMENTIONS];
+    GLubyte color[COLOR_COMPONENTS];
+};
+
+// Strokes of the nodes drawn on the CPU, moved into place on the host and
+// drawn as one triangle strip. Strokes are built once per mesh: bullets and
+// the shuttle share one per type, built on first use, and every meteor gets
+// a cache slot stroked when it spawns. Only uncached nodes are stroked as
+// they are added.
+class OutlineBatch {
+    float halfWidth_;
+    float fringe_;
+    // Batch positions cover the playfield plus a unit on every side
+    float range_;
+    OutlineVertex shared_[NODE_TYPES][OUTLINE_MAX_VERTICES(MAX_VERTEX_COUNT)];
+    int sharedCount_[NODE_TYPES];
+    OutlineVertex cache_[NODE_POOL_CAPACITY][OUTLINE_MAX_VERTICES(MAX_VERTEX_COUNT)];
+    int cacheCount_[NODE_POOL_CAPACITY];
+    int freeSlots_[NODE_POOL_CAPACITY];
+    int freeCount_;
+    OutlineVertex scratch_[OUTLINE_MAX_VERTICES(MAX_VERTEX_COUNT)];
+    OutlineBatchVertex vertices_[OUTLINE_BATCH_VERTICES];
+    int count_;
+
+public:
+    // Widths are in playfield units, no fringe draws hard edges. The aspect
+    // is the playfield's width over its height.
+    OutlineBatch(float halfWidth, float fringe, float aspect);
+    // Strokes the meteor's mesh once. Returns its slot or -1 if the cache is full.
+    int cache(Meteor* meteor);
+    void forget(int slot);
+    void clear() { count_ = 0; }
+    void add(Node* node);
+    // With the scene program, its projection scaled up by getRange()
+    void draw(GLuint hPos, GLuint hCol);
+    float getRange() { return range_; }
+    size_t getBytes() { return sizeof(*this); }
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "particleBatch.h"
+
+#include "glUtil.h"
+
+using namespace ndk_helper;
+
+// Position comes in as two scalar attributes to read the arrays as they are
+const char gParticleVertexShader[] =
+    "uniform highp mat4 uViewProj;\n"
+    "uniform float uLifetime;\n"
+    "uniform float uPointSize;\n"
+    "attribute float aX;\n"
+    "attribute float aY;\n"
+    "attribute float aLife;\n"
+    "varying float vAlpha;\n"
+    "void main() {\n"
+    "  vAlpha = clamp(aLife / uLifetime, 0.0, 1.0);\n"
+    "  gl_PointSize = uPointSize;\n"
+    "  gl_Position = uViewProj * vec4(aX, aY, 0, 1);\n"
+    "}\n";
+
+const char gParticleFragmentShader[] =
+    "precision mediump float;\n"
+    "varying float vAlpha;\n"
+    "void main() {\n"
+    "  gl_FragColor = vec4(0.9608, 0.3608, 0.8902, vAlpha);\n"
+    "}\n";
+
+ParticleBatch::ParticleBatch(GLuint program, Mat4 mVP)
+    : program_(program)
+{
+    aXHandle_ = glGetAttribLocation(program_, "aX");
+    aYHandle_ = glGetAttribLocation(program_, "aY");
+    aLifeHandle_ = glGetAttribLocation(program_, "aLife");
+    uViewProjHandle_ = glGetUniformLocation(program_, "uViewProj");
+    uPointSizeHandle_ = glGetUniformLocation(program_, "uPointSize");
+    glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttribs_);
+    checkGlError("ParticleBatch locations");
+
+    // Neither projection nor lifetime ever change
+    glUseProgram(program_);
+    glUniformMatrix4fv(uViewProjHandle_, 1, GL_FALSE, mVP.Ptr());
+    glUniform1f(glGetUniformLocation(program_, "uLifetime"), ParticleSystem::lifetime);
+    checkGlError("ParticleBatch uniforms");
+}
+
+void ParticleBatch::draw(ParticleSystem& particles, float scale) {
+    if (particles.getCount() == 0) { return; }
+
+    glUseProgram(program_);
+    glUniform1f(uPointSizeHandle_, PARTICLE_POINT_SIZE * scale);
+    // Arrays left enabled by the scene are shorter than the particle count
+    for (GLint i = 0; i < maxAttribs_; ++i) {
+        if (i != (GLint) aXHandle_ && i != (GLint) aYHandle_ && i != (GLint) aLifeHandle_) {
+            glDisableVertexAttribArray(i);
+        }
+    }
+    glVertexAttribPointer(aXHandle_, 1, GL_FLOAT, GL_FALSE, 0, particles.getX());
+    glVertexAttribPointer(aYHandle_, 1, GL_FLOAT, GL_FALSE, 0, particles.getY());
+    glVertexAttribPointer(aLifeHandle_, 1, GL_FLOAT, GL_FALSE, 0, particles.getLife());
+    glEnableVertexAttribArray(aXHandle_);
+    glEnableVertexAttribArray(aYHandle_);
+    glEnableVertexAttribArray(aLifeHandle_);
+    checkGlError("ParticleBatch attributes");
+
+    // Debris fades out, so it is always blended, antialiasing or not
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDrawArrays(GL_POINTS, 0, particles.getCount());
+    checkGlError("glDrawArrays");
+    glDisable(GL_BLEND);
+
+    glDisableVertexAttribArray(aXHandle_);
+    glDisableVertexAttribArray(aYHandle_);
+    glDisableVertexAttribArray(aLifeHandle_);
+}
@@ -0,0 +1,32 @@
+#ifndef PARTICLE_BATCH_H
+#define PARTICLE_BATCH_H
+
+#include <GLES2/gl2.h>
+#include <vecmath.h>
+
+#include "particles.h"
+
+// Point size in pixels at full resolution
+#define PARTICLE_POINT_SIZE 3.0f
+
+extern const char gParticleVertexShader[];
+extern const char gParticleFragmentShader[];
+
+// Draws all particles as one batch of GL_POINTS straight from
+// the arrays of the particle system
+class ParticleBatch {
+    GLuint program_;
+    GLuint aXHandle_;
+    GLuint aYHandle_;
+    GLuint aLifeHandle_;
+    GLuint uViewProjHandle_;
+    GLuint uPointSizeHandle_;
+    GLint maxAttribs_;
+
+public:
+    ParticleBatch(GLuint program, ndk_helper::Mat4 mVP);
+    // Scale of the render target, points keep their size on the screen
+    void draw(ParticleSystem& particles, float scale);
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include "particles.h"
+
+const float ParticleSystem::lifetime = 1.2f;
+const float ParticleSystem::gravity = 0.8f;
+
+ParticleSystem::ParticleSystem(int capacity)
+    : count_(0), capacity_(capacity), peak_(0), random_(1)
+{
+    x_ = new float[capacity_];
+    y_ = new float[capacity_];
+    vx_ = new float[capacity_];
+    vy_ = new float[capacity_];
+    life_ = new float[capacity_];
+}
+
+// Uniform in [-1, 1]
+float ParticleSystem::random() {
+    random_ = random_ * 1664525u + 1013904223u;
+    return (float) (random_ >> 8) / 0x800000 - 1.0f;
+}
+
+void ParticleSystem::emit(float x, float y, int count, float speed) {
+    if (count > capacity_ - count_) { count = capacity_ - count_; }
+
+    for (int i = count_; i < count_ + count; ++i) {
+        x_[i] = x;
+        y_[i] = y;
+        // Square spread with the corners pulled in reads as a round burst
+        float dx = random();
+        float dy = random();
+        float k = speed / (1.0f + 0.4f * (dx * dx + dy * dy));
+        vx_[i] = dx * k;
+        vy_[i] = dy * k;
+        life_[i] = lifetime * (0.5f + 0.25f * (random() + 1.0f));
+    }
+
+    count_ += count;
+    if (count_ > peak_) { peak_ = count_; }
+}
+
+void ParticleSystem::step(float dt) {
+    if (count_ == 0) { return; }
+
+    float* __restrict__ x = x_;
+    float* __restrict__ y = y_;
+    float* __restrict__ vx = vx_;
+    float* __restrict__ vy = vy_;
+    float* __restrict__ life = life_;
+    int count = count_;
+
+    // No branches or calls, so this turns into SIMD code
+    for (int i = 0; i < count; ++i) {
+        vy[i] -= gravity * dt;
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        life[i] -= dt;
+    }
+
+    // Move the last live particle over every dead one
+    int i = 0;
+    while (i < count) {
+        if (life[i] > 0.0f) {
+            ++i;
+            continue;
+        }
+        --count;
+        x[i] = x[count];
+        y[i] = y[count];
+        vx[i] = vx[count];
+        vy[i] = vy[count];
+        life[i] = life[count];
+    }
+    count_ = count;
+}
+
+ParticleSystem::~ParticleSystem() {
+    delete[] x_;
+    delete[] y_;
+    delete[] vx_;
+    delete[] vy_;
+    delete[] life_;
+}
@@ -0,0 +1,46 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PARTICLE_CAPACITY 16384
+
+// Debris of destroyed meteors. Particles are plain data kept as a
+// structure of arrays, so a step is one pass the compiler vectorizes and
+// a frame draws them all as a single batch of points.
+class ParticleSystem {
+    float* x_;
+    float* y_;
+    float* vx_;
+    float* vy_;
+    // Seconds left to live
+    float* life_;
+    int count_;
+    int capacity_;
+    int peak_;
+    // Emission has its own generator so debris doesn't change the game
+    uint32_t random_;
+
+    float random();
+
+public:
+    static const float lifetime;
+    static const float gravity;
+
+    ParticleSystem(int capacity);
+    ~ParticleSystem();
+    // Bursts count particles out of (x, y), dropping what doesn't fit
+    void emit(float x, float y, int count, float speed);
+    void step(float dt);
+    void clear() { count_ = 0; }
+
+    int getCount() { return count_; }
+    int getPeak() { return peak_; }
+    const float* getX() { return x_; }
+    const float* getY() { return y_; }
+    const float* getLife() { return life_; }
+    size_t getBytes() { return capacity_ * 5 * sizeof(float) + sizeof(*this); }
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <stdint.h>
+
+// Random numbers of one world. Every world owns its generator, so worlds
+// can be stepped side by side on any number of threads and each still
+// plays the same for the same seed.
+class Random {
+    uint32_t state_;
+
+public:
+    Random(uint32_t seed) : state_(seed) {};
+    // High bits only, the low bits of a power of two LCG are poor
+    uint32_t next() {
+        state_ = state_ * 1664525u + 1013904223u;
+        return state_ >> 8;
+    }
+    // In [0, 1]
+    float uniform() { return (float) next() / 0xffffff; }
+    // In [0, n)
+    int below(int n) { return (int) (((uint64_t) next() * n) >> 24); }
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "renderTarget.h"
+
+#include "util.h"
+#include "glUtil.h"
+
+const char gUpscaleVertexShader[] =
+    "attribute vec2 aPosition;\n"
+    "attribute vec2 aTexCoord;\n"
+    "varying vec2 vTexCoord;\n"
+    "void main() {\n"
+    "  vTexCoord = aTexCoord;\n"
+    "  gl_Position = vec4(aPosition, 0, 1);\n"
+    "}\n";
+
+const char gUpscaleFragmentShader[] =
+    "precision mediump float;\n"
+    "uniform sampler2D uTexture;\n"
+    "varying vec2 vTexCoord;\n"
+    "void main() {\n"
+    "  gl_FragColor = texture2D(uTexture, vTexCoord);\n"
+    "}\n";
+
+static int scaled(int size, float scale) {
+    int pixels = (int) (size * scale + 0.5f);
+    return pixels > 0 ? pixels : 1;
+}
+
+RenderTarget::RenderTarget(GLuint program, int w, int h, float maxScale)
+    : program_(program), framebuffer_(0), texture_(0), complete_(false), width_(w), height_(h),
+    textureWidth_(scaled(w, maxScale)), textureHeight_(scaled(h, maxScale)),
+    viewWidth_(textureWidth_), viewHeight_(textureHeight_)
+{
+    aPositionHandle_ = glGetAttribLocation(program_, "aPosition");
+    aTexCoordHandle_ = glGetAttribLocation(program_, "aTexCoord");
+    glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttribs_);
+    glUseProgram(program_);
+    glUniform1i(glGetUniformLocation(program_, "uTexture"), 0);
+    checkGlError("RenderTarget locations");
+
+    // Upscaling filters, the texture never has mipmaps
+    glGenTextures(1, &texture_);
+    glBindTexture(GL_TEXTURE_2D, texture_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, textureWidth_, textureHeight_, 0, GL_RGBA,
+        GL_UNSIGNED_BYTE, NULL);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    checkGlError("RenderTarget texture");
+
+    glGenFramebuffers(1, &framebuffer_);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture_, 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    checkGlError("RenderTarget framebuffer");
+
+    complete_ = status == GL_FRAMEBUFFER_COMPLETE;
+    if (complete_) {
+        LOGI("Render target %d x %d for a %d x %d surface", textureWidth_, textureHeight_, w, h);
+    } else {
+        LOGE("Render target is incomplete (0x%x)", status);
+    }
+}
+
+void RenderTarget::bind(float scale) {
+    viewWidth_ = scaled(width_, scale);
+    viewHeight_ = scaled(height_, scale);
+    if (viewWidth_ > textureWidth_) { viewWidth_ = textureWidth_; }
+    if (viewHeight_ > textureHeight_) { viewHeight_ = textureHeight_; }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+    glViewport(0, 0, viewWidth_, viewHeight_);
+    checkGlError("RenderTarget bind");
+}
+
+void RenderTarget::present() {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, width_, height_);
+
+    // Texels past the drawn part hold the clear color, so filtering at the
+    // edge blends with the background only
+    float u = (float) viewWidth_ / textureWidth_;
+    float v = (float) viewHeight_ / textureHeight_;
+    GLfloat quad[] = { -1.0f, -1.0f, 0.0f, 0.0f,
+                        1.0f, -1.0f, u, 0.0f,
+                       -1.0f, 1.0f, 0.0f, v,
+                        1.0f, 1.0f, u, v };
+
+    glUseProgram(program_);
+    // Arrays the scene left enabled may be shorter than the quad
+    for (GLint i = 0; i < maxAttribs_; ++i) {
+        if (i != (GLint) aPositionHandle_ && i != (GLint) aTexCoordHandle_) {
+            glDisableVertexAttribArray(i);
+        }
+    }
+    glVertexAttribPointer(aPositionHandle_, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), quad);
+    glVertexAttribPointer(aTexCoordHandle_, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), quad + 2);
+    glEnableVertexAttribArray(aPositionHandle_);
+    glEnableVertexAttribArray(aTexCoordHandle_);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture_);
+    checkGlError("RenderTarget present");
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    checkGlError("glDrawArrays");
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisableVertexAttribArray(aPositionHandle_);
+    glDisableVertexAttribArray(aTexCoordHandle_);
+}
+
+RenderTarget::~RenderTarget() {
+    if (framebuffer_) { glDeleteFramebuffers(1, &framebuffer_); }
+    if (texture_) { glDeleteTextures(1, &texture_); }
+}
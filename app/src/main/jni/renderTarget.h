@@ -0,0 +1,46 @@
+#ifndef RENDER_TARGET_H
+#define RENDER_TARGET_H
+
+#include <GLES2/gl2.h>
+#include <stddef.h>
+
+extern const char gUpscaleVertexShader[];
+extern const char gUpscaleFragmentShader[];
+
+// Offscreen color buffer the scene is drawn into at a fraction of the
+// surface resolution, then stretched over the surface. The texture has the
+// size of the largest scale, smaller ones draw into its lower left corner,
+// so changing the scale never reallocates.
+class RenderTarget {
+    GLuint program_;
+    GLuint framebuffer_;
+    GLuint texture_;
+    GLuint aPositionHandle_;
+    GLuint aTexCoordHandle_;
+    GLint maxAttribs_;
+    bool complete_;
+
+    // Surface and texture sizes in pixels
+    int width_;
+    int height_;
+    int textureWidth_;
+    int textureHeight_;
+    // Part of the texture drawn at the current scale
+    int viewWidth_;
+    int viewHeight_;
+
+public:
+    RenderTarget(GLuint program, int w, int h, float maxScale);
+    ~RenderTarget();
+    // False if the driver can't render into the texture
+    bool isComplete() { return complete_; }
+    // Directs drawing into the target at scale, clears cover the whole texture
+    void bind(float scale);
+    // Draws the target over the surface and leaves the surface bound
+    void present();
+    int getViewWidth() { return viewWidth_; }
+    int getViewHeight() { return viewHeight_; }
+    size_t getBytes() { return (size_t) textureWidth_ * textureHeight_ * 4; }
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include "resolutionScaler.h"
+
+#include <math.h>
+
+#include "util.h"
+
+// Share of the frame interval the GPU may spend, the rest absorbs spikes
+const double ResolutionScaler::headroom = 0.8;
+// Weight of the newest frame in the filtered GPU time
+const double ResolutionScaler::smoothing = 0.2;
+// Share of the budget frames stay under before the scale goes up
+const double ResolutionScaler::lowWater = 0.7;
+// Frames longer than this stalled on something else than drawing, some
+// drivers also report garbage for the first query
+const double ResolutionScaler::maxGpuTime = 1000.0;
+const int ResolutionScaler::downFrames = 3;
+const int ResolutionScaler::upFrames = 60;
+// Scales are multiples of this, so the render target size settles
+const float ResolutionScaler::step = 0.05f;
+
+ResolutionScaler::ResolutionScaler()
+    : minScale_(0.5f), maxScale_(1.0f), scale_(1.0f), gpuTime_(0.0), overFrames_(0),
+    underFrames_(0)
+{
+    setTargetFps(0);
+    resetStats();
+}
+
+void ResolutionScaler::setLimits(float minScale, float maxScale) {
+    maxScale_ = maxScale;
+    minScale_ = minScale < maxScale ? minScale : maxScale;
+    float scale = scale_ < minScale_ ? minScale_ : (scale_ > maxScale_ ? maxScale_ : scale_);
+    if (scale != scale_) {
+        scale_ = scale;
+        gpuTime_ = 0.0;
+    }
+}
+
+void ResolutionScaler::setTargetFps(int fps) {
+    budget_ = headroom * 1000.0 / (fps > 0 ? fps : 60);
+}
+
+bool ResolutionScaler::addFrame(double gpuTime, float scale) {
+    if (scale != scale_ || gpuTime > maxGpuTime || gpuTime < 0.0) { return false; }
+
+    frames_++;
+    scaleSum_ += scale_;
+    gpuSum_ += gpuTime;
+    gpuTime_ = gpuTime_ > 0.0 ? gpuTime_ + smoothing * (gpuTime - gpuTime_) : gpuTime;
+
+    float next = scale_;
+    if (gpuTime_ > budget_) {
+        underFrames_ = 0;
+        if (++overFrames_ >= downFrames) {
+            // Fill cost goes with the pixel count, aim halfway into the band
+            double target = budget_ * (1.0 + lowWater) / 2;
+            next = scale_ * (float) sqrt(target / gpuTime_);
+            next = floorf(next / step + 0.01f) * step;
+            if (next > scale_ - step) { next = scale_ - step; }
+        }
+    } else if (gpuTime_ < budget_ * lowWater) {
+        overFrames_ = 0;
+        if (++underFrames_ >= upFrames) {
+            // Only if the bigger frames are predicted to stay inside the band
+            float up = scale_ + step;
+            if (gpuTime_ * (up * up) / (scale_ * scale_) < budget_ * (1.0 + lowWater) / 2) {
+                next = up;
+            }
+            underFrames_ = 0;
+        }
+    } else {
+        overFrames_ = 0;
+        underFrames_ = 0;
+    }
+
+    if (next < minScale_) { next = minScale_; }
+    if (next > maxScale_) { next = maxScale_; }
+    if (next == scale_) { return false; }
+
+    gpuTime_ *= (next * next) / (scale_ * scale_);
+    scale_ = next;
+    overFrames_ = 0;
+    underFrames_ = 0;
+    changes_++;
+    return true;
+}
+
+float ResolutionScaler::getMeanScale() {
+    return frames_ > 0 ? (float) (scaleSum_ / frames_) : scale_;
+}
+
+double ResolutionScaler::getMeanGpuTime() {
+    return frames_ > 0 ? gpuSum_ / frames_ : 0.0;
+}
+
+void ResolutionScaler::resetStats() {
+    frames_ = 0;
+    scaleSum_ = 0.0;
+    gpuSum_ = 0.0;
+    changes_ = 0;
+}
+
+void ResolutionScaler::log(const char* name) {
+    if (frames_ == 0) { return; }
+
+    LOGI("%s: scale %.2f in [%.2f, %.2f], mean %.2f, %u changes, GPU %.2f ms of %.2f ms",
+        name, scale_, minScale_, maxScale_, getMeanScale(), changes_, getMeanGpuTime(), budget_);
+}
@@ -0,0 +1,58 @@
+#ifndef RESOLUTION_SCALER_H
+#define RESOLUTION_SCALER_H
+
+// Picks the scale the scene is rendered at from measured GPU frame times.
+// The scale drops quickly when frames go over the budget, by as much as the
+// pixel count predicts, and climbs back one step at a time only after the
+// frames have stayed well under it, so it doesn't flap around the limit.
+class ResolutionScaler {
+    float minScale_;
+    float maxScale_;
+    // Milliseconds of GPU time a frame may take
+    double budget_;
+    float scale_;
+    // Filtered GPU time at the current scale, 0 until the first frame
+    double gpuTime_;
+    // Frames in a row above the budget and below the low water mark
+    int overFrames_;
+    int underFrames_;
+
+    // Statistics of the frames taken
+    unsigned frames_;
+    double scaleSum_;
+    double gpuSum_;
+    unsigned changes_;
+
+    static const double headroom;
+    static const double smoothing;
+    static const double lowWater;
+    static const double maxGpuTime;
+    static const int downFrames;
+    static const int upFrames;
+    static const float step;
+
+public:
+    ResolutionScaler();
+    // Scales are of the surface's width and height, the scale is clamped to them
+    void setLimits(float minScale, float maxScale);
+    float getMinScale() { return minScale_; }
+    float getMaxScale() { return maxScale_; }
+    // The budget is a share of the frame interval, 0 is a 60 Hz display
+    void setTargetFps(int fps);
+    void setBudget(double milliseconds) { budget_ = milliseconds; }
+    double getBudget() { return budget_; }
+
+    // Takes the GPU time in milliseconds of a frame drawn at scale. Frames
+    // drawn before the last change and stalls are ignored. Returns if the
+    // scale changed.
+    bool addFrame(double gpuTime, float scale);
+    float getScale() { return scale_; }
+
+    float getMeanScale();
+    double getMeanGpuTime();
+    unsigned getChanges() { return changes_; }
+    void resetStats();
+    void log(const char* name);
+};
+
+#endif
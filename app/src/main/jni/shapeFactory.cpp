@@ -0,0 +1,189 @@
+#include "shapeFactory.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "util.h"
+#include "trace.h"
+
+ShapeFactory::ShapeFactory(uint32_t seed)
+    : seed_(seed), running_(false), stop_(false), drained_(false), taken_(0), made_(0)
+{
+    memset(rings_, 0, sizeof(rings_));
+
+    for (int count = MIN_VERTEX_COUNT; count < MAX_VERTEX_COUNT; ++count) {
+        for (int i = 0; i < count; ++i) {
+            float a = i * (2 * M_PI) / count;
+            cos_[count][i] = cos(a);
+            sin_[count][i] = sin(a);
+        }
+    }
+}
+
+// Counter based random number in [0, 1], the same on any thread
+float ShapeFactory::random(int stream, int count, unsigned seq, int draw) {
+    uint32_t h = seed_ ^ (stream * 0x27d4eb2fu) ^ (count * 0x9e3779b9u) ^ (seq * 0x85ebca6bu) ^
+        (draw * 0xc2b2ae35u);
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+    return (float) (h >> 8) / 0xffffff;
+}
+
+void ShapeFactory::generate(int stream, int count, unsigned seq, float* vertices) {
+    const float* cosA = cos_[count];
+    const float* sinA = sin_[count];
+
+    /*Random convex hull generation algorithm.*/
+
+    // Generate first point
+    float r1 = random(stream, count, seq, 0) / 2 + 0.5f;
+    float x1 = vertices[0] = r1;
+    float y1 = vertices[1] = 0;
+    float x01 = x1;
+    float y01 = y1;
+
+    // Generate second point
+    float r2 = random(stream, count, seq, 1) / 2 + 0.5f;
+    float x2 = vertices[2] = r2 * cosA[1];
+    float y2 = vertices[3] = r2 * sinA[1];
+    float x02 = x2;
+    float y02 = y2;
+
+    for(int i = 2; i < count - 1; ++i) {
+        float x0 = cosA[i];
+        float y0 = sinA[i];
+
+        float rmax = (y1*x2 - x1*y2) / (y0*(x2-x1) + x0*(y1-y2));
+        rmax = fmin(1.0f, rmax);
+        if (rmax < 0.0f) { rmax = 1.0f; }
+        float rmin = rmax / 2;
+
+        float r = random(stream, count, seq, i) * (rmax - rmin) + rmin;
+        float x = vertices[i * 2] = r * x0;
+        float y = vertices[i * 2 + 1] = r * y0;
+
+        x1 = x2;
+        y1 = y2;
+        x2 = x;
+        y2 = y;
+    }
+
+    float x0 = cosA[count - 1];
+    float y0 = sinA[count - 1];
+    float rmax1 = (y1*x2 - x1*y2) / (y0*(x2-x1) + x0*(y1-y2));
+    float rmax2 = (y01*x02 - x01*y02) / (y0*(x02-x01) + x0*(y01-y02));
+    float rmax = fmin(rmax1, rmax2);
+    rmax = fmin(1.0f, rmax);
+    float rmin = (y1*x01 - x1*y01) / (y0*(x01-x1) + x0*(y1-y01));
+    if (rmax < 0.0f) { rmax = 1.0f; rmin=0.5f; }
+
+    float r = random(stream, count, seq, count - 1) * (rmax - rmin) + rmin;
+
+    int index = (count - 1) * 2;
+    vertices[index] = r * x0;
+    vertices[index + 1] = r * y0;
+}
+
+// Generates the shape and quantizes it for storage
+void ShapeFactory::make(int stream, int count, unsigned seq, int16_t* vertices) {
+    float shape[MAX_VERTEX_COUNT * DIMENTIONS];
+    generate(stream, count, seq, shape);
+    for (int i = 0; i < count * DIMENTIONS; ++i) {
+        vertices[i] = quantizePosition(shape[i]);
+    }
+}
+
+void ShapeFactory::take(ShapeStream stream, int count, int16_t* vertices) {
+    Ring& ring = rings_[stream][count - MIN_VERTEX_COUNT];
+    unsigned next = ring.next;
+
+    unsigned head = __atomic_load_n(&ring.head, __ATOMIC_RELAXED);
+    unsigned tail = __atomic_load_n(&ring.tail, __ATOMIC_ACQUIRE);
+    bool found = false;
+    // Shapes older than next were made here already, drop them
+    while (head != tail && !found) {
+        const MeteorShape& shape = ring.shapes[head & (SHAPE_RING_SIZE - 1)];
+        if (shape.seq == next) {
+            memcpy(vertices, shape.vertices, sizeof(int16_t) * count * DIMENTIONS);
+            found = true;
+        }
+        head++;
+    }
+    __atomic_store_n(&ring.head, head, __ATOMIC_RELEASE);
+
+    if (found) {
+        taken_++;
+    } else {
+        make(stream, count, next, vertices);
+        made_++;
+    }
+    __atomic_store_n(&ring.next, next + 1, __ATOMIC_RELEASE);
+    drained_ = true;
+}
+
+void ShapeFactory::refill() {
+    if (running_ && drained_) { sem_post(&wake_); }
+    drained_ = false;
+}
+
+// Tops up every ring, runs on the worker
+void ShapeFactory::fill() {
+    TRACE_SCOPE("ShapeFactory::fill");
+    for (int stream = 0; stream < SHAPE_STREAMS; ++stream) {
+        for (int count = MIN_VERTEX_COUNT; count < MAX_VERTEX_COUNT; ++count) {
+            Ring& ring = rings_[stream][count - MIN_VERTEX_COUNT];
+            unsigned tail = __atomic_load_n(&ring.tail, __ATOMIC_RELAXED);
+
+            while (tail - __atomic_load_n(&ring.head, __ATOMIC_ACQUIRE) < SHAPE_RING_SIZE) {
+                // Catch up with the shapes the consumer made itself
+                unsigned next = __atomic_load_n(&ring.next, __ATOMIC_ACQUIRE);
+                if ((int) (next - ring.produced) > 0) { ring.produced = next; }
+
+                MeteorShape& shape = ring.shapes[tail & (SHAPE_RING_SIZE - 1)];
+                shape.seq = ring.produced++;
+                make(stream, count, shape.seq, shape.vertices);
+                __atomic_store_n(&ring.tail, ++tail, __ATOMIC_RELEASE);
+            }
+        }
+    }
+}
+
+void* ShapeFactory::run(void* factory) {
+    ShapeFactory* self = (ShapeFactory*) factory;
+    traceThreadName("shape worker");
+    while (!__atomic_load_n(&self->stop_, __ATOMIC_ACQUIRE)) {
+        self->fill();
+        sem_wait(&self->wake_);
+    }
+    return NULL;
+}
+
+void ShapeFactory::startWorker() {
+    if (running_) { return; }
+
+    sem_init(&wake_, 0, 0);
+    stop_ = false;
+    if (pthread_create(&worker_, NULL, run, this) != 0) {
+        LOGE("Could not start the shape worker, shapes are made on spawn.");
+        sem_destroy(&wake_);
+        return;
+    }
+    running_ = true;
+}
+
+void ShapeFactory::stopWorker() {
+    if (!running_) { return; }
+
+    __atomic_store_n(&stop_, true, __ATOMIC_RELEASE);
+    sem_post(&wake_);
+    pthread_join(worker_, NULL);
+    sem_destroy(&wake_);
+    running_ = false;
+}
+
+ShapeFactory::~ShapeFactory() {
+    stopWorker();
+}
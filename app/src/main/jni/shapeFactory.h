@@ -0,0 +1,75 @@
+#ifndef SHAPE_FACTORY_H
+#define SHAPE_FACTORY_H
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdint.h>
+
+#include "meteor.h"
+
+// Must be a power of two
+#define SHAPE_RING_SIZE 16
+
+// Unit convex hull of a meteor, number seq in the sequence of its vertex count
+struct MeteorShape {
+    unsigned seq;
+    // Quantized, see vertexFormat.h
+    int16_t vertices[MAX_VERTEX_COUNT * DIMENTIONS];
+};
+
+// Makes random convex hulls for meteors. A worker thread keeps a lock-free
+// ring of finished shapes for every vertex count, so a spawn only copies one.
+// Shapes are a pure function of the seed, the stream, the vertex count and
+// their number, so the world plays the same with and without the worker.
+class ShapeFactory {
+    // Single producer, single consumer. The consumer skips shapes it
+    // had to make itself when the ring ran dry.
+    struct Ring {
+        MeteorShape shapes[SHAPE_RING_SIZE];
+        unsigned head;
+        unsigned tail;
+        // Number of the next shape the consumer takes
+        unsigned next;
+        // Number of the next shape the worker makes
+        unsigned produced;
+    };
+
+    Ring rings_[SHAPE_STREAMS][MAX_VERTEX_COUNT - MIN_VERTEX_COUNT];
+    // Unit circle points of a regular polygon for every vertex count
+    float cos_[MAX_VERTEX_COUNT][MAX_VERTEX_COUNT];
+    float sin_[MAX_VERTEX_COUNT][MAX_VERTEX_COUNT];
+    uint32_t seed_;
+
+    pthread_t worker_;
+    sem_t wake_;
+    bool running_;
+    bool stop_;
+    // Shapes were taken since the worker was woken last
+    bool drained_;
+
+    unsigned taken_;
+    unsigned made_;
+
+    float random(int stream, int count, unsigned seq, int draw);
+    void generate(int stream, int count, unsigned seq, float* vertices);
+    void make(int stream, int count, unsigned seq, int16_t* vertices);
+    void fill();
+    static void* run(void* factory);
+
+public:
+    ShapeFactory(uint32_t seed);
+    ~ShapeFactory();
+    void startWorker();
+    void stopWorker();
+    // Writes the next shape of the stream with count vertices,
+    // MIN_VERTEX_COUNT <= count < MAX_VERTEX_COUNT
+    void take(ShapeStream stream, int count, int16_t* vertices);
+    // Wakes the worker to refill what was taken, keeps the wake up
+    // system call out of spawn bursts
+    void refill();
+    // Shapes popped from the rings and made on the spot when they ran dry
+    unsigned getTaken() { return taken_; }
+    unsigned getMade() { return made_; }
+};
+
+#endif
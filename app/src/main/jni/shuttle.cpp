@@ -1,55 +1,43 @@
-#ifndef SHUTTLE_CPP
-#define SHUTTLE_CPP
+#include "shuttle.h"
 
-#include <GLES2/gl2.h>
-#include "node.cpp"
-
-class Shuttle: public Node {
-
-    static const float speed = 0.15f;
-
-public:
-    Shuttle();
-    NodeType getType() { return SHUTTLE; };
-    bool isIntersect(Node* node);
-    float getSpeed() { return speed; }
-};
+const float Shuttle::speed = 0.15f;
 
 Shuttle::Shuttle() {
     vertexCount_ = 3;
 
-    vertices_ = new GLfloat[vertexCount_ * DIMENTIONS];
-    vertices_[0] = 0.0f;    vertices_[1] = 1.0f;
-    vertices_[2] = -0.5f;   vertices_[3] = 0.0f;
-    vertices_[4] = 0.5f;    vertices_[5] = 0.0f;
-
-    colors_ = new GLfloat[vertexCount_ * COLOR_COMPONENTS];
-    for(int i = 0; i < vertexCount_ * COLOR_COMPONENTS; i+=COLOR_COMPONENTS ) {
-        colors_[i] = 0.3686f;
-        colors_[i + 1] = 1.0f;
-        colors_[i + 2] = 0.1529f;
-        colors_[i + 3] = 1.0;
-    }
+    vertices_ = vertexStorage_;
+    vertices_[0] = quantizePosition(0.0f);    vertices_[1] = quantizePosition(1.0f);
+    vertices_[2] = quantizePosition(-0.5f);   vertices_[3] = quantizePosition(0.0f);
+    vertices_[4] = quantizePosition(0.5f);    vertices_[5] = quantizePosition(0.0f);
+
+    colors_ = colorStorage_;
+    fillColor(colors_, vertexCount_, 0.3686f, 1.0f, 0.1529f, 1.0f);
 
     scale(0.15f, 0.15f);
     y_ = -0.95f;
 }
 
+// Highest point of the shuttle, nothing above it can hit the shuttle
+float Shuttle::getTop() {
+    float xmin, xmax, ymin, ymax;
+    getBounds(xmin, xmax, ymin, ymax);
+
+    return y_ + ymax;
+}
+
 bool Shuttle::isIntersect(Node* node) {
     if (vertices_ == NULL) {
         return false;
     }
 
     for (int i = 0; i < vertexCount_; ++i) {
-        float x = vertices_[i * 2] + x_;
-        float y = vertices_[i * 2 + 1] + y_;
+        float x, y;
+        getVertex(i, x, y);
 
-        if (node->isInside(x, y)) {
+        if (node->isInside(x + x_, y + y_)) {
             return true;
         }
     }
 
     return false;
 }
-
-#endif
\ No newline at end of file
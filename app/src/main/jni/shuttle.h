@@ -0,0 +1,22 @@
+#ifndef SHUTTLE_H
+#define SHUTTLE_H
+
+#include "node.h"
+
+class Shuttle: public Node {
+
+    static const float speed;
+    int16_t vertexStorage_[3 * DIMENTIONS];
+    uint8_t colorStorage_[3 * COLOR_COMPONENTS];
+
+public:
+    Shuttle();
+    NodeType getType() { return SHUTTLE; };
+    size_t getFootprint() { return sizeof(*this); };
+    bool isIntersect(Node* node);
+    // Farthest a tap moves the shuttle
+    static float getSpeed() { return speed; }
+    float getTop();
+};
+
+#endif
@@ -1,26 +1,9 @@
-#ifndef SMALL_METEOR_CPP
-#define SMALL_METEOR_CPP
+#include "smallMeteor.h"
 
-#include <GLES2/gl2.h>
-#include <math.h>
-
-#include "meteor.cpp"
-
-class SmallMeteor: public Meteor {
-
-public:
-    SmallMeteor(float x, float y);
-    NodeType getType() { return SMALL_METEOR; };
-};
-
-SmallMeteor::SmallMeteor(float x, float y)
-    : Meteor() {
+SmallMeteor::SmallMeteor(ShapeFactory& shapes, Random& random, float x, float y, double time)
+    : Meteor(shapes, random, SHAPES_SMALL_METEOR) {
     // Make it small
     scale(0.3f, 0.3f);
-    // Translate from current coordinates to the specified
-    translate(x - x_, y - y_);
-    // Update x speed
-    updateXSpeed();
+    // Start falling from the specified point
+    launch(x, y, time, random);
 }
-
-#endif
\ No newline at end of file
@@ -0,0 +1,14 @@
+#ifndef SMALL_METEOR_H
+#define SMALL_METEOR_H
+
+#include "meteor.h"
+
+class SmallMeteor: public Meteor {
+
+public:
+    SmallMeteor(ShapeFactory& shapes, Random& random, float x, float y, double time);
+    NodeType getType() { return SMALL_METEOR; };
+    size_t getFootprint() { return sizeof(*this); };
+};
+
+#endif
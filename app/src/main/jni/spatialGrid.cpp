@@ -0,0 +1,101 @@
+#include "spatialGrid.h"
+
+#include <math.h>
+
+using namespace std;
+
+#define CELL_WIDTH ((XMAX - XMIN) / GRID_SIZE)
+#define CELL_HEIGHT ((YMAX - YMIN) / GRID_SIZE)
+
+// Anything off the grid falls into the edge cells
+int SpatialGrid::column(float x) {
+    int c = (int) floorf((x - XMIN) / CELL_WIDTH);
+    return c < 0 ? 0 : (c >= GRID_SIZE ? GRID_SIZE - 1 : c);
+}
+
+int SpatialGrid::row(float y) {
+    int r = (int) floorf((y - YMIN) / CELL_HEIGHT);
+    return r < 0 ? 0 : (r >= GRID_SIZE ? GRID_SIZE - 1 : r);
+}
+
+void SpatialGrid::clear() {
+    count_ = 0;
+    for (int i = 0; i <= GRID_CELLS; ++i) { cellStart_[i] = 0; }
+}
+
+void SpatialGrid::build(const vector<Node*>& scene) {
+    int counts[GRID_CELLS + 1];
+    for (int i = 0; i <= GRID_CELLS; ++i) { counts[i] = 0; }
+
+    // Count the meteors of every cell
+    Node* picked[GRID_CAPACITY];
+    int count = 0;
+    for (vector<Node*>::const_iterator node = scene.begin();
+        node < scene.end() && count < GRID_CAPACITY; ++node) {
+        enum NodeType type = (*node)->getType();
+        if ((*node)->isRemoved() || !(type == METEOR || type == SMALL_METEOR)) { continue; }
+
+        cell_[count] = row((*node)->getY()) * GRID_SIZE + column((*node)->getX());
+        counts[cell_[count] + 1]++;
+        picked[count++] = *node;
+    }
+
+    // Prefix sums give where every cell starts, then place the nodes
+    for (int i = 0; i < GRID_CELLS; ++i) { counts[i + 1] += counts[i]; }
+    for (int i = 0; i <= GRID_CELLS; ++i) { cellStart_[i] = counts[i]; }
+    for (int i = 0; i < count; ++i) {
+        nodes_[counts[cell_[i]]++] = picked[i];
+    }
+    count_ = count;
+}
+
+int SpatialGrid::nearest(float x, float y, int k, Node** out) {
+    if (k <= 0 || count_ == 0) { return 0; }
+    if (k > GRID_CAPACITY) { k = GRID_CAPACITY; }
+
+    float distances[GRID_CAPACITY];
+    int found = 0;
+    int cx = column(x);
+    int cy = row(y);
+
+    // Visit rings of cells around (x, y) until no closer node can be left
+    for (int ring = 0; ring < GRID_SIZE; ++ring) {
+        if (found == k) {
+            // Nodes in this ring are at least ring - 1 cells away
+            float reach = (ring - 1) * fmin(CELL_WIDTH, CELL_HEIGHT);
+            if (reach > 0.0f && reach * reach >= distances[found - 1]) { break; }
+        }
+
+        for (int r = cy - ring; r <= cy + ring; ++r) {
+            if (r < 0 || r >= GRID_SIZE) { continue; }
+            // Inner rows only have the two edge cells of the ring
+            int step = (r == cy - ring || r == cy + ring) ? 1 : 2 * ring;
+            for (int c = cx - ring; c <= cx + ring; c += step > 0 ? step : 1) {
+                if (c < 0 || c >= GRID_SIZE) { continue; }
+
+                int cell = r * GRID_SIZE + c;
+                for (int i = cellStart_[cell]; i < cellStart_[cell + 1]; ++i) {
+                    Node* node = nodes_[i];
+                    if (node->isRemoved()) { continue; }
+
+                    float dx = node->getX() - x;
+                    float dy = node->getY() - y;
+                    float d = dx * dx + dy * dy;
+                    if (found == k && d >= distances[found - 1]) { continue; }
+
+                    // Insertion into the sorted k best
+                    int j = found < k ? found++ : found - 1;
+                    while (j > 0 && distances[j - 1] > d) {
+                        distances[j] = distances[j - 1];
+                        out[j] = out[j - 1];
+                        --j;
+                    }
+                    distances[j] = d;
+                    out[j] = node;
+                }
+            }
+        }
+    }
+
+    return found;
+}
@@ -0,0 +1,35 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <vector>
+
+#include "node.h"
+
+// Cells per side, the grid covers the playfield from XMIN, YMIN to XMAX, YMAX
+#define GRID_SIZE 8
+#define GRID_CELLS (GRID_SIZE * GRID_SIZE)
+// Nodes past this many are left out of the grid
+#define GRID_CAPACITY 256
+
+// Uniform grid of meteors for nearest neighbour queries. It is rebuilt
+// once per step with a counting sort and holds no allocations.
+class SpatialGrid {
+    Node* nodes_[GRID_CAPACITY];
+    int cell_[GRID_CAPACITY];
+    // Nodes of cell i are nodes_[cellStart_[i]] up to nodes_[cellStart_[i + 1]]
+    int cellStart_[GRID_CELLS + 1];
+    int count_;
+
+    static int column(float x);
+    static int row(float y);
+
+public:
+    SpatialGrid() { clear(); };
+    void build(const std::vector<Node*>& scene);
+    void clear();
+    // Writes up to k live meteors closest to (x, y) to out, nearest first.
+    // Returns how many were found.
+    int nearest(float x, float y, int k, Node** out);
+};
+
+#endif
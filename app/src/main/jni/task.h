@@ -0,0 +1,31 @@
+#ifndef TASK_H
+#define TASK_H
+
+class World;
+
+// Resumable task in the style of protothreads. The body of resume() is one
+// switch over the line the task last waited at, so every call carries on
+// right after that wait. Locals don't survive a wait, whatever the task
+// keeps across one is a member. The task waits in simulation time and is
+// resumed at the exact time it asked for, whatever the frame rate.
+class Task {
+protected:
+    // Line of the last wait, 0 before the first resume and -1 once done
+    int line_;
+
+public:
+    Task() : line_(0) {};
+    virtual ~Task() {};
+    // Runs at its due time until it waits. Returns the seconds until it
+    // wants to run again, negative once it is done.
+    virtual double resume(double time, World& world) = 0;
+    bool isDone() { return line_ < 0; }
+    void restart() { line_ = 0; }
+};
+
+// Waits may not share a line, and not sit inside a switch of the body
+#define TASK_BEGIN() switch (line_) { case 0:
+#define TASK_WAIT(seconds) do { line_ = __LINE__; return (seconds); case __LINE__:; } while (0)
+#define TASK_END() } line_ = -1; return -1.0
+
+#endif
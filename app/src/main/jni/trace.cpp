@@ -0,0 +1,175 @@
+#include "trace.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "util.h"
+
+bool gTraceEnabled = false;
+
+static TraceBuffer* buffers[TRACE_MAX_THREADS];
+static int bufferCount = 0;
+static pthread_mutex_t registry = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t bufferKey;
+static pthread_once_t keyOnce = PTHREAD_ONCE_INIT;
+
+static FILE* file = NULL;
+static pthread_t writer;
+static bool writing = false;
+static int64_t startTime = 0;
+static bool firstEvent = true;
+
+// Lets a new thread reuse the buffer once this one is gone
+static void releaseBuffer(void* buffer) {
+    __atomic_store_n(&((TraceBuffer*) buffer)->owned, false, __ATOMIC_RELEASE);
+}
+
+static void createKey() {
+    pthread_key_create(&bufferKey, releaseBuffer);
+}
+
+// Buffer of the calling thread, registered on its first event
+static TraceBuffer* threadBuffer() {
+    pthread_once(&keyOnce, createKey);
+    TraceBuffer* buffer = (TraceBuffer*) pthread_getspecific(bufferKey);
+    if (buffer != NULL) { return buffer; }
+
+    pthread_mutex_lock(&registry);
+    // Only buffers the writer emptied, or old events would get the new tid
+    for (int i = 0; i < bufferCount && buffer == NULL; ++i) {
+        if (!__atomic_load_n(&buffers[i]->owned, __ATOMIC_ACQUIRE) &&
+            __atomic_load_n(&buffers[i]->head, __ATOMIC_ACQUIRE) == buffers[i]->tail) {
+            buffer = buffers[i];
+        }
+    }
+    if (buffer == NULL && bufferCount < TRACE_MAX_THREADS) {
+        buffer = (TraceBuffer*) calloc(1, sizeof(TraceBuffer));
+        if (buffer != NULL) { buffers[bufferCount++] = buffer; }
+    }
+    if (buffer != NULL) {
+        buffer->tid = (int) syscall(SYS_gettid);
+        __atomic_store_n(&buffer->owned, true, __ATOMIC_RELEASE);
+        pthread_setspecific(bufferKey, buffer);
+    }
+    pthread_mutex_unlock(&registry);
+
+    return buffer;
+}
+
+void traceEvent(const char* name, int64_t begin, int64_t end) {
+    TraceBuffer* buffer = threadBuffer();
+    if (buffer == NULL) { return; }
+
+    unsigned tail = __atomic_load_n(&buffer->tail, __ATOMIC_RELAXED);
+    unsigned head = __atomic_load_n(&buffer->head, __ATOMIC_ACQUIRE);
+    if (tail - head == TRACE_BUFFER_SIZE) {
+        buffer->dropped++;
+        return;
+    }
+
+    TraceEvent& event = buffer->events[tail & (TRACE_BUFFER_SIZE - 1)];
+    event.name = name;
+    event.begin = begin;
+    event.end = end;
+    __atomic_store_n(&buffer->tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+void traceThreadName(const char* name) {
+    if (!gTraceEnabled) { return; }
+
+    traceEvent(name, 0, 0);
+}
+
+static void writeEvent(int tid, const TraceEvent& event) {
+    fputs(firstEvent ? "\n" : ",\n", file);
+    firstEvent = false;
+
+    if (event.end == 0) {
+        fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+            "\"args\":{\"name\":\"%s\"}}", tid, event.name);
+    } else {
+        fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+            "\"pid\":1,\"tid\":%d}", event.name, (event.begin - startTime) / 1e3,
+            (event.end - event.begin) / 1e3, tid);
+    }
+}
+
+// Moves everything recorded so far to the file
+static void drain() {
+    pthread_mutex_lock(&registry);
+    int count = bufferCount;
+    pthread_mutex_unlock(&registry);
+
+    for (int i = 0; i < count; ++i) {
+        TraceBuffer* buffer = buffers[i];
+        unsigned head = __atomic_load_n(&buffer->head, __ATOMIC_RELAXED);
+        unsigned tail = __atomic_load_n(&buffer->tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            writeEvent(buffer->tid, buffer->events[head & (TRACE_BUFFER_SIZE - 1)]);
+        }
+        __atomic_store_n(&buffer->head, head, __ATOMIC_RELEASE);
+    }
+    fflush(file);
+}
+
+static void* writeLoop(void*) {
+    // Tracing may not be enabled yet, so the name skips traceThreadName
+    traceEvent("trace writer", 0, 0);
+
+    // A frame fills a few dozen events, so this keeps the buffers far from full
+    struct timespec period = { 0, 5000000 };
+    while (__atomic_load_n(&writing, __ATOMIC_ACQUIRE)) {
+        drain();
+        nanosleep(&period, NULL);
+    }
+    return NULL;
+}
+
+bool traceStart(const char* path) {
+    if (file != NULL) { return true; }
+
+    file = fopen(path, "w");
+    if (file == NULL) {
+        LOGE("Could not open trace file %s", path);
+        return false;
+    }
+    // The closing bracket is optional, so a killed app still leaves a valid trace
+    fputs("[", file);
+    firstEvent = true;
+    startTime = monotonicNanos();
+
+    writing = true;
+    if (pthread_create(&writer, NULL, writeLoop, NULL) != 0) {
+        LOGE("Could not start the trace writer");
+        writing = false;
+        fclose(file);
+        file = NULL;
+        return false;
+    }
+
+    __atomic_store_n(&gTraceEnabled, true, __ATOMIC_RELEASE);
+    LOGI("Tracing to %s", path);
+    return true;
+}
+
+void traceStop() {
+    if (file == NULL) { return; }
+
+    __atomic_store_n(&gTraceEnabled, false, __ATOMIC_RELEASE);
+    __atomic_store_n(&writing, false, __ATOMIC_RELEASE);
+    pthread_join(writer, NULL);
+    drain();
+
+    unsigned dropped = 0;
+    for (int i = 0; i < bufferCount; ++i) { dropped += buffers[i]->dropped; }
+    fputs("\n]\n", file);
+    fclose(file);
+    file = NULL;
+
+    LOGI("Trace written, %u events dropped", dropped);
+}
@@ -0,0 +1,68 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util.h"
+
+// Must be a power of two
+#define TRACE_BUFFER_SIZE 4096
+// Threads that can record at the same time
+#define TRACE_MAX_THREADS 32
+
+// A finished scope, or a thread name when end is 0.
+// Names must be string literals.
+struct TraceEvent {
+    const char* name;
+    int64_t begin;
+    int64_t end;
+};
+
+// Events of one thread. The thread pushes, the writer pops.
+struct TraceBuffer {
+    TraceEvent events[TRACE_BUFFER_SIZE];
+    unsigned head;
+    unsigned tail;
+    unsigned dropped;
+    int tid;
+    // Taken by a live thread, free ones are handed to new threads
+    bool owned;
+};
+
+extern bool gTraceEnabled;
+
+// Starts streaming events to a Chrome trace file (JSON array format),
+// which chrome://tracing and ui.perfetto.dev open. Returns false if the
+// file can't be written.
+bool traceStart(const char* path);
+// Writes what is left and closes the file
+void traceStop();
+void traceEvent(const char* name, int64_t begin, int64_t end);
+// Shows up as the thread's name in the viewer
+void traceThreadName(const char* name);
+
+// Records the lifetime of a C++ scope. Costs one branch when tracing is off.
+// Begin and end go out as one event, so a full buffer never leaves a
+// scope open in the viewer.
+class TraceScope {
+    const char* name_;
+    int64_t begin_;
+
+public:
+    TraceScope(const char* name) : name_(NULL), begin_(0) {
+        if (__builtin_expect(gTraceEnabled, 0)) {
+            name_ = name;
+            begin_ = monotonicNanos();
+        }
+    };
+    ~TraceScope() {
+        if (name_ != NULL) { traceEvent(name_, begin_, monotonicNanos()); }
+    };
+};
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+#endif
@@ -1,20 +1,26 @@
-#ifndef UTIL_CPP
-#define UTIL_CPP
+#include "util.h"
 
-#define LOG_TAG "gunner"
-#include <JNIHelper.h>
-#include <android/log.h>
-#include <GLES2/gl2.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
 
-static void printGLString(const char *name, GLenum s) {
-    const char *v = (const char *) glGetString(s);
-    LOGI("GL %s = %s\n", name, v);
+int64_t monotonicNanos() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) now.tv_sec * 1000000000LL + now.tv_nsec;
 }
 
-static void checkGlError(const char* op) {
-    for (GLint error = glGetError(); error; error = glGetError()) {
-        LOGI("after %s() glError (0x%x)\n", op, error);
-    }
-}
+#ifndef __ANDROID__
+void hostLog(bool error, const char* format, ...) {
+    FILE* out = error ? stderr : stdout;
+
+    va_list args;
+    va_start(args, format);
+    vfprintf(out, format, args);
+    va_end(args);
 
-#endif
\ No newline at end of file
+    size_t length = strlen(format);
+    if (length == 0 || format[length - 1] != '\n') { fputc('\n', out); }
+}
+#endif
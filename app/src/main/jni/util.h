@@ -0,0 +1,21 @@
+#ifndef UTIL_H
+#define UTIL_H
+
+#include <stdint.h>
+
+#define LOG_TAG "gunner"
+
+#ifdef __ANDROID__
+#include <JNIHelper.h>
+#include <android/log.h>
+#else
+// Host builds log to the console
+void hostLog(bool error, const char* format, ...);
+#define LOGI(...) hostLog(false, __VA_ARGS__)
+#define LOGE(...) hostLog(true, __VA_ARGS__)
+#endif
+
+// Nanoseconds of CLOCK_MONOTONIC, the clock input events are stamped with
+int64_t monotonicNanos();
+
+#endif
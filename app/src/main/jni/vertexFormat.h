@@ -0,0 +1,39 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <stdint.h>
+
+// Geometry is stored compact and uploaded as is. Positions are normalized
+// shorts in [-1, 1], drawn with GL_SHORT, and colors are RGBA bytes, drawn
+// with GL_UNSIGNED_BYTE. Both attributes are normalized by GL.
+#define POSITION_ONE 32767
+#define COLOR_ONE 255
+
+inline int16_t quantizePosition(float value) {
+    if (value > 1.0f) { value = 1.0f; }
+    if (value < -1.0f) { value = -1.0f; }
+    float scaled = value * POSITION_ONE;
+    return (int16_t) (scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+}
+
+inline float dequantizePosition(int16_t value) {
+    return (float) value / POSITION_ONE;
+}
+
+inline uint8_t quantizeColor(float value) {
+    if (value > 1.0f) { value = 1.0f; }
+    if (value < 0.0f) { value = 0.0f; }
+    return (uint8_t) (value * COLOR_ONE + 0.5f);
+}
+
+// Fills count vertices with one RGBA color
+inline void fillColor(uint8_t* colors, int count, float r, float g, float b, float a) {
+    for (int i = 0; i < count * 4; i += 4) {
+        colors[i] = quantizeColor(r);
+        colors[i + 1] = quantizeColor(g);
+        colors[i + 2] = quantizeColor(b);
+        colors[i + 3] = quantizeColor(a);
+    }
+}
+
+#endif
@@ -0,0 +1,42 @@
+#include "waveScheduler.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// std heaps keep the largest on top, so the later timer compares less
+struct TimerLater {
+    bool operator()(const Timer& a, const Timer& b) const {
+        return a.time > b.time || (a.time == b.time && a.order > b.order);
+    }
+};
+
+WaveScheduler::WaveScheduler()
+    : order_(0), resumes_(0)
+{
+    heap_.reserve(WAVE_MAX_TASKS);
+}
+
+void WaveScheduler::start(Task* task, double time) {
+    Timer timer = { time, order_++, task };
+    heap_.push_back(timer);
+    push_heap(heap_.begin(), heap_.end(), TimerLater());
+}
+
+void WaveScheduler::run(double now, World& world) {
+    while (!heap_.empty() && heap_[0].time <= now) {
+        pop_heap(heap_.begin(), heap_.end(), TimerLater());
+        Timer timer = heap_.back();
+        heap_.pop_back();
+
+        double wait = timer.task->resume(timer.time, world);
+        resumes_++;
+        if (wait < 0.0) { continue; }
+
+        // Due times add up from the last one, never from the frame
+        timer.time += wait;
+        timer.order = order_++;
+        heap_.push_back(timer);
+        push_heap(heap_.begin(), heap_.end(), TimerLater());
+    }
+}
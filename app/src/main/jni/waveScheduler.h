@@ -0,0 +1,39 @@
+#ifndef WAVE_SCHEDULER_H
+#define WAVE_SCHEDULER_H
+
+#include <vector>
+
+#include "task.h"
+
+// Tasks a world runs at most, the heap never grows past them
+#define WAVE_MAX_TASKS 8
+
+struct Timer {
+    double time;
+    // Order of scheduling, tasks due at the same time run first come first
+    unsigned order;
+    Task* task;
+};
+
+// Binary min-heap of task timers in simulation time. A step only looks at
+// the earliest timer, so frames between spawns cost one comparison, and
+// due tasks run in a fixed order, so a seed always replays the same.
+class WaveScheduler {
+    std::vector<Timer> heap_;
+    unsigned order_;
+    unsigned resumes_;
+
+public:
+    WaveScheduler();
+    // The task first runs at time, the scheduler doesn't own it
+    void start(Task* task, double time);
+    void clear() { heap_.clear(); }
+    // Resumes every task due by now at its own due time, as often as it stays due
+    void run(double now, World& world);
+    int size() { return heap_.size(); }
+    // Due time of the earliest task, negative when none is left
+    double getNextTime() { return heap_.empty() ? -1.0 : heap_[0].time; }
+    unsigned getResumes() { return resumes_; }
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include "waves.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "world.h"
+
+using namespace std;
+
+void DifficultyCurve::add(float time, float rate) {
+    DifficultyPoint point = { time, rate };
+    vector<DifficultyPoint>::iterator at = points_.begin();
+    while (at != points_.end() && at->time <= time) { ++at; }
+    points_.insert(at, point);
+}
+
+float DifficultyCurve::getRate(double time) {
+    if (points_.empty()) { return 0.0f; }
+    if (time <= points_.front().time) { return points_.front().rate * scale_; }
+
+    for (size_t i = 1; i < points_.size(); ++i) {
+        const DifficultyPoint& a = points_[i - 1];
+        const DifficultyPoint& b = points_[i];
+        if (time < b.time) {
+            float t = (float) (time - a.time) / (b.time - a.time);
+            return (a.rate + (b.rate - a.rate) * t) * scale_;
+        }
+    }
+    return points_.back().rate * scale_;
+}
+
+// A meteor a second all game long and no bursts, the game's balance from
+// before the waves. Bursts, once given an interval, sweep five meteors.
+WaveSettings::WaveSettings()
+    : burstInterval(0.0f), burstSize(5), burstSpacing(0.2f)
+{
+    DifficultyPoint flat = { 0.0f, 1.0f };
+    curve.push_back(flat);
+}
+
+bool WaveSettings::parseCurve(const char* text) {
+    curve.clear();
+    while (*text) {
+        char* end;
+        DifficultyPoint point;
+        point.time = strtof(text, &end);
+        if (end == text || *end != ':') { return false; }
+        text = end + 1;
+        point.rate = strtof(text, &end);
+        if (end == text || (*end != ',' && *end != '\0')) { return false; }
+        curve.push_back(point);
+        text = *end == ',' ? end + 1 : end;
+    }
+    return !curve.empty();
+}
+
+double MeteorStream::resume(double time, World& world) {
+    TASK_BEGIN();
+    while (true) {
+        if (curve_->getRate(time) <= 0.0f) {
+            // Nothing to spawn yet, look again in a second
+            TASK_WAIT(1.0);
+            continue;
+        }
+        // Gaps of a Poisson process at the rate of the last spawn
+        TASK_WAIT(-log(1.0 - random_.uniform() * 0.999999) / curve_->getRate(time));
+        world.spawnMeteor(random_.uniform() * world.getSky() - world.getSky() / 2, time,
+            random_.next());
+    }
+    TASK_END();
+}
+
+void MeteorBurst::set(float interval, int size, float spacing) {
+    interval_ = interval;
+    size_ = size;
+    spacing_ = spacing;
+}
+
+double MeteorBurst::resume(double time, World& world) {
+    TASK_BEGIN();
+    while (interval_ > 0.0f) {
+        TASK_WAIT(interval_);
+        // Bursts may have been switched off while it waited
+        if (interval_ <= 0.0f) { break; }
+
+        // Edge to edge, starting on a random side
+        dx_ = size_ > 1 ? world.getSky() / (size_ - 1) : 0.0f;
+        x_ = -world.getSky() / 2;
+        if (random_.uniform() < 0.5f) {
+            x_ = -x_;
+            dx_ = -dx_;
+        }
+        for (spawned_ = 0; spawned_ < size_ && interval_ > 0.0f; ++spawned_) {
+            world.spawnMeteor(x_ + spawned_ * dx_, time, random_.next());
+            TASK_WAIT(spacing_);
+        }
+    }
+    TASK_END();
+}
@@ -0,0 +1,74 @@
+#ifndef WAVES_H
+#define WAVES_H
+
+#include <vector>
+
+#include "task.h"
+#include "random.h"
+
+struct DifficultyPoint {
+    // Seconds into the game
+    float time;
+    // Meteors per second
+    float rate;
+};
+
+// Spawn rate over a game, linear between its points and flat before the
+// first and past the last. The scale multiplies the whole curve.
+class DifficultyCurve {
+    std::vector<DifficultyPoint> points_;
+    float scale_;
+
+public:
+    DifficultyCurve() : scale_(1.0f) {};
+    void clear() { points_.clear(); }
+    // Points are kept in time order whatever order they come in
+    void add(float time, float rate);
+    void setScale(float scale) { scale_ = scale; }
+    float getRate(double time);
+};
+
+// How a world spawns, the defaults are the game's
+struct WaveSettings {
+    std::vector<DifficultyPoint> curve;
+    // Seconds between bursts, 0 for none
+    float burstInterval;
+    int burstSize;
+    float burstSpacing;
+
+    WaveSettings();
+    // Parses "time:rate,time:rate...", false if malformed
+    bool parseCurve(const char* text);
+};
+
+// Meteors at random across the sky, as a Poisson process following the curve
+class MeteorStream: public Task {
+    Random random_;
+    DifficultyCurve* curve_;
+
+public:
+    MeteorStream(unsigned seed, DifficultyCurve* curve) : random_(seed), curve_(curve) {};
+    double resume(double time, World& world);
+};
+
+// Every interval a line of meteors sweeping across the sky from either side
+class MeteorBurst: public Task {
+    Random random_;
+    float interval_;
+    int size_;
+    float spacing_;
+    // The burst under way
+    int spawned_;
+    float x_;
+    float dx_;
+
+public:
+    MeteorBurst(unsigned seed) : random_(seed), interval_(0.0f), size_(0), spacing_(0.0f),
+        spawned_(0), x_(0.0f), dx_(0.0f) {};
+    // No interval ends the task at its next resume, cutting short a burst
+    // under way
+    void set(float interval, int size, float spacing);
+    double resume(double time, World& world);
+};
+
+#endif
@@ -0,0 +1,334 @@
+#include "world.h"
+
+#include <math.h>
+#include <new>
+
+#include "util.h"
+#include "trace.h"
+#include "allocTracker.h"
+
+using namespace std;
+
+// Every node type spawned while playing fits a slot
+static size_t nodeSlotSize() {
+    size_t size = sizeof(Bullet);
+    if (sizeof(Meteor) > size) { size = sizeof(Meteor); }
+    if (sizeof(SmallMeteor) > size) { size = sizeof(SmallMeteor); }
+    return size;
+}
+
+World::World(float sky, unsigned seed)
+    : sky_(sky), smallMeteorX_(0.0f), smallMeteorY_(0.0f), score_(0), isOver_(false),
+    time_(0.0), hasRemoved_(false), pool_(nodeSlotSize(), NODE_POOL_CAPACITY), shapes_(seed),
+    particles_(PARTICLE_CAPACITY), random_(seed), stream_(seed * 2246822519u + 1, &difficulty_),
+    burst_(seed * 2246822519u + 2), debris_(48), listener_(NULL)
+{
+    // Containers never grow while playing, every node has room up front
+    scene_.reserve(NODE_POOL_CAPACITY + 1);
+    threats_.reserve(NODE_POOL_CAPACITY + 1);
+    events_.reserve((NODE_POOL_CAPACITY + 1) * EVENT_TYPES);
+
+    shuttle_ = new Shuttle();
+    scene_.push_back(shuttle_);
+    budget_.add(SHUTTLE, shuttle_->getFootprint());
+
+    setWaves(WaveSettings());
+    waves_.start(&stream_, 0.0);
+    waves_.start(&burst_, 0.0);
+    updateStorage();
+}
+
+void World::setWaves(const WaveSettings& waves) {
+    difficulty_.clear();
+    for (size_t i = 0; i < waves.curve.size(); ++i) {
+        difficulty_.add(waves.curve[i].time, waves.curve[i].rate);
+    }
+
+    burst_.set(waves.burstInterval, waves.burstSize, waves.burstSpacing);
+    // A finished burst task starts over
+    if (burst_.isDone() && waves.burstInterval > 0.0f) {
+        burst_.restart();
+        waves_.start(&burst_, time_);
+    }
+}
+
+bool World::spawnMeteor(float x, double time, uint32_t seed) {
+    ALLOC_TAG("World::spawnMeteor");
+    // Spread the seeds, consecutive LCG states start out alike
+    Random random(seed * 2654435761u);
+    void* slot = allocateNode(METEOR, sizeof(Meteor));
+    if (slot == NULL) {
+        // Use up its shape all the same, so the meteors after it keep theirs
+        int16_t shape[MAX_VERTEX_COUNT * DIMENTIONS];
+        shapes_.take(SHAPES_METEOR, Meteor::randomVertexCount(random), shape);
+        return false;
+    }
+
+    Meteor* meteor = new (slot) Meteor(shapes_, random);
+    meteor->launch(x, 1.0f, time, random);
+    addMeteor(meteor);
+    return true;
+}
+
+// Room for a node from the pool, NULL if the budget or the pool is out of
+// it. Either way the budget counts the node as refused.
+void* World::allocateNode(NodeType type, size_t bytes) {
+    if (!budget_.canAdd(type, bytes)) { return NULL; }
+
+    void* slot = pool_.allocate();
+    if (slot == NULL) { budget_.recordRefused(); }
+    return slot;
+}
+
+// Takes ownership of the meteor built in a slot of allocateNode
+void World::addMeteor(Meteor* meteor) {
+    budget_.add(meteor->getType(), meteor->getFootprint());
+    scene_.push_back(meteor);
+
+    // The whole trajectory is known, so predict when the meteor matters
+    events_.schedule(meteor, EVENT_EXIT, meteor->getExitTime());
+    events_.schedule(meteor, EVENT_THREAT, meteor->getThreatTime(shuttle_->getTop()));
+
+    if (listener_ != NULL) { listener_->onMeteorAdded(meteor); }
+}
+
+void World::removeNode(Node* node) {
+    if (listener_ != NULL) { listener_->onNodeRemoved(node); }
+
+    events_.cancel(node);
+    budget_.release(node->getType(), node->getFootprint());
+    if (pool_.owns(node)) {
+        node->~Node();
+        pool_.release(node);
+    } else {
+        delete node;
+    }
+}
+
+void World::tap(float x, float y) {
+    fire(x, y, time_, 0);
+}
+
+// Shoots from the shuttle at the given simulation time and moves the
+// shuttle towards x, the height of the tap doesn't matter. A non zero tap
+// time is kept on the bullet for the renderer.
+void World::fire(float x, float, double time, int64_t tapTime) {
+    ALLOC_TAG("World::fire");
+    void* slot = allocateNode(BULLET, sizeof(Bullet));
+    if (slot != NULL) {
+        Bullet* bullet = new (slot) Bullet();
+        bullet->launch(shuttle_->getX(), time);
+        bullet->updateAt(time_);
+        bullet->setTapTime(tapTime);
+        scene_.push_back(bullet);
+        events_.schedule(bullet, EVENT_EXIT, bullet->getExitTime());
+        budget_.add(BULLET, bullet->getFootprint());
+    }
+
+    float dx = x - shuttle_->getX();
+    dx = copysignf(1.0, dx) * fmin(shuttle_->getSpeed(), fabs(dx));
+
+    shuttle_->translate(dx, 0.0f);
+}
+
+// Applies the queued taps. A tap made some time before frameTime happened
+// that much earlier in the simulation, but never before the step began.
+void World::consumeInput(double dt, int64_t frameTime) {
+    TapEvent tap;
+    while (input_.pop(tap)) {
+        double age = fmin(fmax((frameTime - tap.time) / 1e9, 0.0), dt);
+        fire(tap.x, tap.y, time_ - age, tap.time);
+    }
+}
+
+void World::step(double dt, int64_t frameTime) {
+    TRACE_SCOPE("World::step");
+    ALLOC_TAG("World::step");
+    dt = fmin(dt, 1.0f);
+    time_ += dt;
+
+    consumeInput(dt, frameTime);
+
+    // Despawn whatever left the playfield and pick up new threats
+    processEvents();
+
+    // Spawn whatever the waves have due, at the times they are due
+    waves_.run(time_, *this);
+
+    particles_.step(dt);
+
+    for (vector<Node*>::iterator node = scene_.begin(); node < scene_.end(); ++node) {
+        if ((*node)->isRemoved()) { continue; }
+
+        enum NodeType type = (*node)->getType();
+
+        // Move and spin the meteor along its trajectory.
+        // Leaving the playfield and hitting the shuttle are handled by events.
+        if (type == METEOR || type == SMALL_METEOR) {
+            ((Meteor*) (*node))->updateAt(time_);
+        }
+
+        if (type == BULLET) {
+            updateBullet((Bullet*) (*node));
+        }
+    }
+
+    // Only meteors that reached the shuttle band can end the game
+    {
+        TRACE_SCOPE("shuttle collision");
+        for (vector<Node*>::iterator node = threats_.begin(); node < threats_.end(); ++node) {
+            if (!(*node)->isRemoved() && shuttle_->isIntersect(*node)) {
+                isOver_ = true;
+            }
+        }
+    }
+
+    sweepRemoved();
+
+    // If flag is set than it's time to spawn small ones
+    // And if we hit meteor at (0, 0), well.. than it's a lucky shot
+    if (smallMeteorX_ || smallMeteorY_) {
+        ALLOC_TAG("World::step small meteors");
+        for (int i = 0; i < smallMeteors; ++i) {
+            void* slot = allocateNode(SMALL_METEOR, sizeof(SmallMeteor));
+            if (slot == NULL) { break; }
+            addMeteor(new (slot) SmallMeteor(shapes_, random_, smallMeteorX_, smallMeteorY_, time_));
+        }
+        // Clear the spawn flag
+        smallMeteorX_ = smallMeteorY_ = 0.0f;
+    }
+    shapes_.refill();
+
+    grid_.build(scene_);
+    updateStorage();
+}
+
+void World::updateStorage() {
+    budget_.setStorage(scene_.capacity() * sizeof(Node*) + threats_.capacity() * sizeof(Node*) +
+        events_.getCapacityBytes() + pool_.getFreeBytes() + sizeof(shapes_) + particles_.getBytes());
+}
+
+// A bullet is off-threat if no meteor is above it within its column
+bool World::isOffThreat(Bullet* bullet) {
+    for (vector<Node*>::iterator node = scene_.begin(); node < scene_.end(); ++node) {
+        enum NodeType type = (*node)->getType();
+        if ((*node)->isRemoved() || !(type == METEOR || type == SMALL_METEOR)) { continue; }
+
+        float xmin, xmax, ymin, ymax;
+        (*node)->getBounds(xmin, xmax, ymin, ymax);
+        if (bullet->getX() >= (*node)->getX() + xmin && bullet->getX() <= (*node)->getX() + xmax &&
+            bullet->getY() <= (*node)->getY() + ymax) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Sheds load under memory pressure: drops the bullets that can't hit
+// anything any more and the debris. Containers keep their storage, it is
+// sized for the caps and would only be allocated again.
+void World::trimMemory() {
+    int shed = 0;
+    for (vector<Node*>::iterator node = scene_.begin(); node < scene_.end(); ++node) {
+        if ((*node)->getType() == BULLET && !(*node)->isRemoved() && isOffThreat((Bullet*) (*node))) {
+            (*node)->markRemoved();
+            hasRemoved_ = true;
+            shed++;
+        }
+    }
+    sweepRemoved();
+    // Debris is only for the looks
+    particles_.clear();
+    grid_.build(scene_);
+
+    budget_.recordShed(shed);
+    updateStorage();
+
+    const MemoryStats& stats = budget_.getStats();
+    LOGI("Memory trimmed: shed %d nodes, current %u bytes, peak %u bytes",
+        shed, (unsigned) stats.currentBytes, (unsigned) stats.peakBytes);
+}
+
+void World::processEvents() {
+    Event event;
+    while (events_.pop(time_, event)) {
+        switch (event.type) {
+        case EVENT_EXIT:
+            event.node->markRemoved();
+            hasRemoved_ = true;
+            break;
+        case EVENT_THREAT:
+            threats_.push_back(event.node);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// Deletes the nodes marked as removed during the step
+void World::sweepRemoved() {
+    if (!hasRemoved_) { return; }
+    hasRemoved_ = false;
+
+    vector<Node*>::iterator end = threats_.begin();
+    for (vector<Node*>::iterator node = threats_.begin(); node < threats_.end(); ++node) {
+        if (!(*node)->isRemoved()) { *end++ = *node; }
+    }
+    threats_.erase(end, threats_.end());
+
+    end = scene_.begin();
+    for (vector<Node*>::iterator node = scene_.begin(); node < scene_.end(); ++node) {
+        if ((*node)->isRemoved()) {
+            removeNode(*node);
+        } else {
+            *end++ = *node;
+        }
+    }
+    scene_.erase(end, scene_.end());
+}
+
+void World::updateBullet(Bullet* bullet) {
+    // Move the bullet up
+    bullet->updateAt(time_);
+
+    // Detect if bullet hit meteor
+    TRACE_SCOPE("bullet collision");
+    for (vector<Node*>::iterator node = scene_.begin(); node < scene_.end(); ++node) {
+        if ((*node)->isRemoved()) { continue; }
+
+        enum NodeType type = (*node)->getType();
+
+        // And if it hit...
+        if ((type == METEOR || type == SMALL_METEOR) && bullet->isIntersect(*node)) {
+            // Remove the bullet
+            bullet->markRemoved();
+            // Remove the meteor
+            (*node)->markRemoved();
+            hasRemoved_ = true;
+
+            // And if it is a big one set flag to spawn small meteors
+            Meteor* meteor = (Meteor*) (*node);
+            if (type == METEOR) {
+                smallMeteorX_ = meteor->getX();
+                smallMeteorY_ = meteor->getY();
+                particles_.emit(meteor->getX(), meteor->getY(), debris_, 0.5f);
+
+                score_++;
+            } else {
+                particles_.emit(meteor->getX(), meteor->getY(), debris_ / 2, 0.3f);
+                score_ += 2;
+            }
+
+            // The bullet is gone, it can't hit anything else
+            break;
+        }
+    }
+}
+
+World::~World() {
+    for (vector<Node*>::iterator node = scene_.begin(); node < scene_.end(); ++node) {
+        removeNode(*node);
+    }
+}
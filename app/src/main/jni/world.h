@@ -0,0 +1,125 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "node.h"
+#include "shuttle.h"
+#include "meteor.h"
+#include "smallMeteor.h"
+#include "bullet.h"
+#include "eventQueue.h"
+#include "memoryBudget.h"
+#include "inputQueue.h"
+#include "shapeFactory.h"
+#include "particles.h"
+#include "spatialGrid.h"
+#include "nodePool.h"
+#include "random.h"
+#include "waveScheduler.h"
+#include "waves.h"
+
+// Told about nodes coming and going, so a renderer can keep
+// its own resources in sync with the world
+class WorldListener {
+public:
+    virtual ~WorldListener() {};
+    virtual void onMeteorAdded(Meteor* meteor) = 0;
+    // Called right before the node is deleted
+    virtual void onNodeRemoved(Node* node) = 0;
+};
+
+// The whole simulation without any rendering. Nodes move by time only,
+// so the world steps the same on a device and in a headless run.
+class World {
+    float sky_;
+    float smallMeteorX_;
+    float smallMeteorY_;
+    int score_;
+    bool isOver_;
+    double time_;
+
+    Shuttle* shuttle_;
+    std::vector<Node*> scene_;
+    // Meteors low enough to touch the shuttle
+    std::vector<Node*> threats_;
+    EventQueue events_;
+    bool hasRemoved_;
+    NodePool pool_;
+    MemoryBudget budget_;
+    InputQueue input_;
+    // Meteors by position, rebuilt at the end of every step
+    SpatialGrid grid_;
+    ShapeFactory shapes_;
+    ParticleSystem particles_;
+    Random random_;
+    // Spawning is scripted by tasks waiting on the scheduler's timers. They
+    // draw from their own generators, so hits never shift the spawns.
+    DifficultyCurve difficulty_;
+    MeteorStream stream_;
+    MeteorBurst burst_;
+    WaveScheduler waves_;
+    // Particles a big meteor bursts into, small ones give half
+    int debris_;
+    WorldListener* listener_;
+
+    static const int smallMeteors = 4;
+
+    void updateBullet(Bullet* bullet);
+    void* allocateNode(NodeType type, size_t bytes);
+    void removeNode(Node* node);
+    void addMeteor(Meteor* meteor);
+    void processEvents();
+    void sweepRemoved();
+    bool isOffThreat(Bullet* bullet);
+    void fire(float x, float y, double time, int64_t tapTime);
+    void consumeInput(double dt, int64_t frameTime);
+    void updateStorage();
+
+public:
+    // Sky is the half width of the playfield, meteors spawn across it
+    World(float sky, unsigned seed);
+    ~World();
+    void setListener(WorldListener* listener) { listener_ = listener; }
+    void step(double dt, int64_t frameTime);
+    void tap(float x, float y);
+    // Taps queued here are applied at their own time within the next step
+    InputQueue& getInput() { return input_; }
+    // Start its worker to take shape generation off the step
+    ShapeFactory& getShapes() { return shapes_; }
+    ParticleSystem& getParticles() { return particles_; }
+    void setDebris(int count) { debris_ = count; }
+    // Scales the difficulty curve
+    void setSpawnRate(float rate) { difficulty_.setScale(rate); }
+    // Meteors per second over the game, changes apply from the next spawn
+    DifficultyCurve& getDifficulty() { return difficulty_; }
+    // Replaces the curve and the bursts, no burst interval stops them
+    void setWaves(const WaveSettings& waves);
+    // Launches a meteor from the top of the sky at the given time of this
+    // step, false if the budget or the pool has no room for it. The meteor
+    // draws its size and fall from its own seed and its shape from the
+    // meteor shape sequence, so neither refused meteors nor hits change the
+    // meteors after it.
+    bool spawnMeteor(float x, double time, uint32_t seed);
+    unsigned getWaveResumes() { return waves_.getResumes(); }
+    // Nothing on screen moves until the next spawn or tap: only the shuttle
+    // is left and the debris has settled
+    bool isStatic() { return isOver_ || (scene_.size() == 1 && particles_.getCount() == 0); }
+    // Simulation time of the next spawn, negative when the waves are over
+    double getNextSpawn() { return waves_.getNextTime(); }
+    const std::vector<Node*>& getScene() { return scene_; }
+    Shuttle* getShuttle() { return shuttle_; }
+    float getSky() { return sky_; }
+    // Up to k meteors nearest to (x, y) as of the last step, nearest first
+    int findNearest(float x, float y, int k, Node** out) { return grid_.nearest(x, y, k, out); }
+    double getTime() { return time_; }
+    bool isOver() { return isOver_; }
+    int getScore() { return score_; }
+    void trimMemory();
+    // Caps and the hard limit are configured through the budget
+    MemoryBudget& getMemoryBudget() { return budget_; }
+    const MemoryStats& getMemoryStats() { return budget_.getStats(); }
+};
+
+#endif